@@ -0,0 +1,431 @@
+// ChartCache.cpp
+#include "ChartCache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+
+//------------------------------------ XXH64 ------------------------------------
+
+static const unsigned long long PRIME64_1 = 0x9E3779B185EBCA87ULL;
+static const unsigned long long PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+static const unsigned long long PRIME64_3 = 0x165667B19E3779F9ULL;
+static const unsigned long long PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+static const unsigned long long PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+static inline unsigned long long Rotl64(unsigned long long x, int r) { return (x << r) | (x >> (64 - r)); }
+static inline unsigned long long Read64(const unsigned char* p) { unsigned long long v; memcpy(&v, p, 8); return v; }
+static inline unsigned int Read32(const unsigned char* p) { unsigned int v; memcpy(&v, p, 4); return v; }
+
+static inline unsigned long long XxhRound(unsigned long long acc, unsigned long long input) {
+    acc += input * PRIME64_2;
+    acc = Rotl64(acc, 31);
+    return acc * PRIME64_1;
+}
+
+static inline unsigned long long XxhMerge(unsigned long long acc, unsigned long long val) {
+    acc ^= XxhRound(0, val);
+    return acc * PRIME64_1 + PRIME64_4;
+}
+
+unsigned long long Hash64(const void* data, size_t len, unsigned long long seed) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    const unsigned char* end = p + len;
+    unsigned long long h;
+
+    if (len >= 32) {
+        unsigned long long v1 = seed + PRIME64_1 + PRIME64_2;
+        unsigned long long v2 = seed + PRIME64_2;
+        unsigned long long v3 = seed;
+        unsigned long long v4 = seed - PRIME64_1;
+        const unsigned char* limit = end - 32;
+        do {
+            v1 = XxhRound(v1, Read64(p));
+            v2 = XxhRound(v2, Read64(p + 8));
+            v3 = XxhRound(v3, Read64(p + 16));
+            v4 = XxhRound(v4, Read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+        h = Rotl64(v1, 1) + Rotl64(v2, 7) + Rotl64(v3, 12) + Rotl64(v4, 18);
+        h = XxhMerge(h, v1);
+        h = XxhMerge(h, v2);
+        h = XxhMerge(h, v3);
+        h = XxhMerge(h, v4);
+    }
+    else {
+        h = seed + PRIME64_5;
+    }
+
+    h += static_cast<unsigned long long>(len);
+    while (p + 8 <= end) {
+        h ^= XxhRound(0, Read64(p));
+        h = Rotl64(h, 27) * PRIME64_1 + PRIME64_4;
+        p += 8;
+    }
+    if (p + 4 <= end) {
+        h ^= static_cast<unsigned long long>(Read32(p)) * PRIME64_1;
+        h = Rotl64(h, 23) * PRIME64_2 + PRIME64_3;
+        p += 4;
+    }
+    while (p < end) {
+        h ^= (*p) * PRIME64_5;
+        h = Rotl64(h, 11) * PRIME64_1;
+        p++;
+    }
+
+    h ^= h >> 33;
+    h *= PRIME64_2;
+    h ^= h >> 29;
+    h *= PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+//------------------------------------ ANAHTAR ------------------------------------
+
+#define CHART_KEY_VERSION 3   // izim kodu kty deitirirse artrlmal; eski disk girdileri kullanlmaz
+
+template <class T> static void KeyAppend(std::vector<unsigned char>& k, const T& v) {
+    const unsigned char* b = reinterpret_cast<const unsigned char*>(&v);
+    k.insert(k.end(), b, b + sizeof(T));
+}
+
+static void KeyAppendString(std::vector<unsigned char>& k, const char* s) {
+    unsigned int n = s ? static_cast<unsigned int>(strlen(s)) : 0;
+    KeyAppend(k, n);
+    k.insert(k.end(), s, s + n);
+}
+
+unsigned long long PieChartKey(const std::vector<PieSliceInfo>& slices, const char* chart_title,
+    int image_width, int image_height, int center_x, int center_y, int radius,
+    unsigned int backcolor, unsigned int textcolor, int canvas_bits) {
+
+    std::vector<unsigned char> k;
+    k.reserve(64 + slices.size() * 48);
+    KeyAppend(k, CHART_KEY_VERSION);
+    KeyAppendString(k, chart_title);
+    KeyAppend(k, image_width);
+    KeyAppend(k, image_height);
+    KeyAppend(k, center_x);
+    KeyAppend(k, center_y);
+    KeyAppend(k, radius);
+    KeyAppend(k, backcolor);
+    KeyAppend(k, textcolor);
+    KeyAppend(k, canvas_bits);   // 4/8 bit paletli BMP ile 32 bit BMP farkl dosyalardr
+    // Ham deer yerine yzde ve alar kullanlr: resme yansyan bilgi bunlardr
+    for (const auto& slice : slices) {
+        KeyAppendString(k, slice.label.c_str());
+        KeyAppend(k, slice.percentage);
+        KeyAppend(k, slice.start_angle_deg);
+        KeyAppend(k, slice.end_angle_deg);
+        KeyAppend(k, slice.color);
+    }
+    return Hash64(k.data(), k.size());
+}
+
+//------------------------------------ NBELLEK ------------------------------------
+
+// Diske yazlmay bekleyen baytlarn st snr; disk yavasa render i paracklar beklemez,
+// fazlas yalnzca bellekte kalr
+static const unsigned long long DISK_WRITE_BACKLOG = 64ull << 20;
+
+ChartCache::ChartCache(const ChartCacheConfig& config) : cfg(config) {
+    if (cfg.shards < 1) cfg.shards = 1;
+    for (int i = 0; i < cfg.shards; i++) shards.emplace_back(new Shard);
+    shard_limit = cfg.memory_limit / cfg.shards;
+
+    if (cfg.disk_dir.empty()) return;
+    CreateDirectoryA(cfg.disk_dir.c_str(), NULL);
+
+    // Yarda kalm yazmalarn geici dosyalar hibir girdiye ait deildir
+    WIN32_FIND_DATAA fd;
+    std::string pattern = cfg.disk_dir + "\\*.tmp";
+    HANDLE h = FindFirstFileA(pattern.c_str(), &fd);
+    if (h != INVALID_HANDLE_VALUE) {
+        do {
+            if (!(fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+                DeleteFileA((cfg.disk_dir + "\\" + fd.cFileName).c_str());
+        } while (FindNextFileA(h, &fd));
+        FindClose(h);
+    }
+
+    // nceki almalardan kalan dosyalar son yazlma zamanna gre LRU srasna koy.
+    // Dosya ad "<16 hane anahtar>-<kuak>.bmp" biimindedir; kuaksz eski adlar nceki
+    // srmlerin anahtarlardr ve bir daha istenmeyeceklerinden silinir.
+    struct Found { unsigned long long when, key, size, generation; };
+    std::vector<Found> found;
+    pattern = cfg.disk_dir + "\\*.bmp";
+    h = FindFirstFileA(pattern.c_str(), &fd);
+    if (h != INVALID_HANDLE_VALUE) {
+        do {
+            if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) continue;
+            char* endp = nullptr;
+            unsigned long long key = _strtoui64(fd.cFileName, &endp, 16);
+            if (endp != fd.cFileName + 16) continue;
+            if (strcmp(endp, ".bmp") == 0) {
+                DeleteFileA((cfg.disk_dir + "\\" + fd.cFileName).c_str());
+                continue;
+            }
+            if (*endp != '-') continue;
+            const char* gen_start = endp + 1;
+            unsigned long long generation = _strtoui64(gen_start, &endp, 16);
+            if (endp == gen_start || strcmp(endp, ".bmp") != 0) continue;
+            unsigned long long size = (static_cast<unsigned long long>(fd.nFileSizeHigh) << 32) | fd.nFileSizeLow;
+            unsigned long long when = (static_cast<unsigned long long>(fd.ftLastWriteTime.dwHighDateTime) << 32) | fd.ftLastWriteTime.dwLowDateTime;
+            found.push_back({ when, key, size, generation });
+        } while (FindNextFileA(h, &fd));
+        FindClose(h);
+    }
+    std::sort(found.begin(), found.end(), [](const Found& a, const Found& b) { return a.when < b.when; });
+    for (const auto& f : found) {
+        // Ayn anahtarn eski kua kalmsa (silinemeden kapanm) yenisi geerlidir
+        auto it = disk_files.find(f.key);
+        if (it != disk_files.end()) {
+            if (it->second.generation > f.generation) {
+                DeleteFileA(DiskPath(f.key, f.generation).c_str());
+                continue;
+            }
+            DeleteFileA(DiskPath(f.key, it->second.generation).c_str());
+        }
+        TouchDisk(f.key, f.size, f.generation);
+        disk_generation = (std::max)(disk_generation, f.generation);
+    }
+
+    // Snr kltlm olabilir: en eski dosyalar silinerek disk_limit'e inilir
+    while (disk_bytes > cfg.disk_limit && !disk_order.empty()) {
+        unsigned long long victim = disk_order.begin()->second;
+        auto it = disk_files.find(victim);
+        DeleteFileA(DiskPath(victim, it->second.generation).c_str());
+        disk_bytes -= it->second.size;
+        disk_order.erase(disk_order.begin());
+        disk_files.erase(it);
+    }
+
+    writer = std::thread(&ChartCache::DiskWriter, this);
+}
+
+ChartCache::~ChartCache() {
+    if (!writer.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(write_mtx);
+        write_stop = true;
+    }
+    write_cv.notify_all();
+    writer.join();
+}
+
+std::string ChartCache::DiskPath(unsigned long long key, unsigned long long generation) const {
+    char name[48];
+    sprintf_s(name, sizeof(name), "\\%016llx-%llx.bmp", key, generation);
+    return cfg.disk_dir + name;
+}
+
+// disk_mtx tutulurken arlr
+void ChartCache::TouchDisk(unsigned long long key, unsigned long long size, unsigned long long generation) {
+    auto it = disk_files.find(key);
+    if (it != disk_files.end()) {
+        disk_order.erase(it->second.tick);
+        disk_bytes -= it->second.size;
+    }
+    unsigned long long tick = ++disk_tick;
+    disk_files[key] = { size, tick, generation };
+    disk_order[tick] = key;
+    disk_bytes += size;
+}
+
+bool ChartCache::Get(unsigned long long key, ChartBytes& out, bool count_miss) {
+    if (cfg.memory_limit > 0) {
+        Shard& s = ShardFor(key);
+        std::lock_guard<std::mutex> lock(s.mtx);
+        auto it = s.map.find(key);
+        if (it != s.map.end()) {
+            s.lru.splice(s.lru.begin(), s.lru, it->second);
+            out = it->second->second;
+            memory_hits++;
+            return true;
+        }
+    }
+    if (!cfg.disk_dir.empty() && GetDisk(key, out)) {
+        disk_hits++;
+        PutMemory(key, out);
+        return true;
+    }
+    if (count_miss) misses++;
+    return false;
+}
+
+void ChartCache::Put(unsigned long long key, const ChartBytes& bytes) {
+    if (!bytes) return;
+    PutMemory(key, bytes);
+    if (!cfg.disk_dir.empty()) PutDisk(key, bytes);
+}
+
+void ChartCache::PutMemory(unsigned long long key, const ChartBytes& bytes) {
+    if (cfg.memory_limit == 0 || bytes->size() > shard_limit) return;
+
+    Shard& s = ShardFor(key);
+    std::lock_guard<std::mutex> lock(s.mtx);
+    auto it = s.map.find(key);
+    if (it != s.map.end()) {
+        s.lru.splice(s.lru.begin(), s.lru, it->second);
+        return;
+    }
+    s.lru.emplace_front(key, bytes);
+    s.map[key] = s.lru.begin();
+    s.bytes += bytes->size();
+
+    while (s.bytes > shard_limit) {
+        auto& victim = s.lru.back();
+        s.bytes -= victim.second->size();
+        s.map.erase(victim.first);
+        s.lru.pop_back();
+        evictions++;
+    }
+}
+
+// Girdiyi indeksten karr; disk_mtx tutulurken arlr, dosyay aran kilit dnda siler.
+// Girdi bu arada yeniden eklenmi ya da kullanlmsa (sra deimise) dokunulmaz ve false dner.
+bool ChartCache::DropDisk(unsigned long long key, unsigned long long tick, unsigned long long& generation) {
+    auto it = disk_files.find(key);
+    if (it == disk_files.end() || it->second.tick != tick) return false;
+    generation = it->second.generation;
+    disk_bytes -= it->second.size;
+    disk_order.erase(tick);
+    disk_files.erase(it);
+    return true;
+}
+
+bool ChartCache::GetDisk(unsigned long long key, ChartBytes& out) {
+    unsigned long long size, tick, generation;
+    {
+        std::lock_guard<std::mutex> lock(disk_mtx);
+        auto it = disk_files.find(key);
+        if (it == disk_files.end()) return false;
+        size = it->second.size;
+        generation = it->second.generation;
+        TouchDisk(key, size, generation);
+        tick = disk_tick;
+    }
+
+    // Kuak adn paras olduundan bu arada silinen dosyann yerine ayn adla baka bir
+    // dosya gelemez; en kt durumda ama baarsz olur ve skalama saylr.
+    bool ok = false;
+    std::shared_ptr<std::vector<unsigned char>> data;
+    std::string path = DiskPath(key, generation);
+    HANDLE f = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL,
+        OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (f != INVALID_HANDLE_VALUE) {
+        data = std::make_shared<std::vector<unsigned char>>(static_cast<size_t>(size));
+        DWORD got = 0;
+        ok = size < 0x80000000ull && ReadFile(f, data->data(), static_cast<DWORD>(size), &got, NULL) && got == size &&
+            size >= 2 && (*data)[0] == 'B' && (*data)[1] == 'M';
+        CloseHandle(f);
+    }
+    if (!ok) {
+        // Dosya dardan silinmi ya da bozuk: girdi kalrsa anahtar hep skalar ama yer kaplar
+        bool dropped;
+        {
+            std::lock_guard<std::mutex> lock(disk_mtx);
+            dropped = DropDisk(key, tick, generation);
+        }
+        if (dropped) DeleteFileA(path.c_str());
+        return false;
+    }
+    out = data;
+    return true;
+}
+
+// Yalnzca yazc kuyruuna ekler; dosya ilemleri DiskWriter'da yaplr
+void ChartCache::PutDisk(unsigned long long key, const ChartBytes& bytes) {
+    if (bytes->size() > cfg.disk_limit) return;
+    {
+        std::lock_guard<std::mutex> lock(disk_mtx);
+        if (disk_files.count(key)) return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(write_mtx);
+        if (write_stop || write_pending.count(key)) return;
+        if (write_queue_bytes + bytes->size() > DISK_WRITE_BACKLOG) return;
+        write_pending.insert(key);
+        write_queue.emplace_back(key, bytes);
+        write_queue_bytes += bytes->size();
+    }
+    write_cv.notify_one();
+}
+
+void ChartCache::DiskWriter() {
+    std::unique_lock<std::mutex> lock(write_mtx);
+    for (;;) {
+        write_cv.wait(lock, [this] { return write_stop || !write_queue.empty(); });
+        // Kapanta kuyrukta kalanlar da yazlr
+        if (write_queue.empty()) return;
+        auto item = std::move(write_queue.front());
+        write_queue.pop_front();
+        lock.unlock();
+
+        WriteDisk(item.first, item.second);
+
+        lock.lock();
+        write_queue_bytes -= item.second->size();
+        write_pending.erase(item.first);
+    }
+}
+
+void ChartCache::WriteDisk(unsigned long long key, const ChartBytes& bytes) {
+    unsigned long long generation;
+    {
+        std::lock_guard<std::mutex> lock(disk_mtx);
+        if (disk_files.count(key)) return;
+        generation = ++disk_generation;
+    }
+
+    // nce geici dosyaya yaz, sonra yeniden adlandr: okuyucular yarm dosya grmesin.
+    // Her iki ad da kuaa gre tekildir; baka bir yazma ya da gecikmi bir silme bunlara dokunamaz.
+    std::string path = DiskPath(key, generation);
+    std::string tmp = path + ".tmp";
+    HANDLE f = CreateFileA(tmp.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (f == INVALID_HANDLE_VALUE) return;
+    DWORD written = 0;
+    bool ok = WriteFile(f, bytes->data(), static_cast<DWORD>(bytes->size()), &written, NULL) && written == bytes->size();
+    CloseHandle(f);
+    if (!ok || !MoveFileExA(tmp.c_str(), path.c_str(), 0)) {
+        DeleteFileA(tmp.c_str());
+        return;
+    }
+
+    // Kilit altnda yalnzca indeks gncellenir; silinecek dosyalarn adlar toplanp sonra silinir
+    std::vector<std::string> victims;
+    {
+        std::lock_guard<std::mutex> lock(disk_mtx);
+        TouchDisk(key, bytes->size(), generation);
+        while (disk_bytes > cfg.disk_limit && !disk_order.empty()) {
+            unsigned long long victim = disk_order.begin()->second;
+            auto it = disk_files.find(victim);
+            victims.push_back(DiskPath(victim, it->second.generation));
+            disk_bytes -= it->second.size;
+            disk_order.erase(disk_order.begin());
+            disk_files.erase(it);
+            evictions++;
+        }
+    }
+    for (const auto& v : victims) DeleteFileA(v.c_str());
+}
+
+ChartCacheStats ChartCache::Stats() {
+    ChartCacheStats st;
+    st.memory_hits = memory_hits;
+    st.disk_hits = disk_hits;
+    st.misses = misses;
+    st.evictions = evictions;
+    st.memory_bytes = 0;
+    for (auto& s : shards) {
+        std::lock_guard<std::mutex> lock(s->mtx);
+        st.memory_bytes += s->bytes;
+    }
+    {
+        std::lock_guard<std::mutex> lock(disk_mtx);
+        st.disk_bytes = disk_bytes;
+    }
+    return st;
+}
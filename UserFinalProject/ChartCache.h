@@ -0,0 +1,110 @@
+// ChartCache.h
+// izilmi grafiklerin ierik adresli nbellei. Anahtar, normalize edilmi dilim
+// listesi ve izim parametrelerinin 64 bit zetidir (XXH64); deer kodlanm
+// BMP dosya baytlardr. Bellekte paral (sharded) LRU, istee bal olarak
+// diskte dosya bana bir girdi tutulur. Disk yazmalar arka plandaki tek bir
+// yazc i paracnda yaplr. Tm metotlar i parac gvenlidir.
+#pragma once
+#include "PieChart.h"
+
+#include <vector>
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+
+typedef std::shared_ptr<const std::vector<unsigned char>> ChartBytes;
+
+// XXH64 zeti
+unsigned long long Hash64(const void* data, size_t len, unsigned long long seed = 0);
+
+// CreatePieChart'a verilecek parametrelerin anahtar. Dilimler BuildPieSlices
+// kts olduundan ayn oranlara sahip veri setleri ayn anahtar retir.
+unsigned long long PieChartKey(const std::vector<PieSliceInfo>& slices, const char* chart_title,
+    int image_width, int image_height, int center_x, int center_y, int radius,
+    unsigned int backcolor, unsigned int textcolor, int canvas_bits = 32);
+
+struct ChartCacheConfig {
+    unsigned long long memory_limit = 256ull << 20;  // bayt, 0: bellek katman kapal
+    int shards = 16;
+    std::string disk_dir;                            // bosa disk katman kapal
+    unsigned long long disk_limit = 1ull << 30;      // bayt
+};
+
+struct ChartCacheStats {
+    unsigned long long memory_hits;
+    unsigned long long disk_hits;
+    unsigned long long misses;
+    unsigned long long evictions;
+    unsigned long long memory_bytes;
+    unsigned long long disk_bytes;
+};
+
+class ChartCache
+{
+    struct Shard {
+        std::mutex mtx;
+        std::list<std::pair<unsigned long long, ChartBytes>> lru;   // ba: en son kullanlan
+        std::unordered_map<unsigned long long, std::list<std::pair<unsigned long long, ChartBytes>>::iterator> map;
+        unsigned long long bytes = 0;
+    };
+
+    ChartCacheConfig cfg;
+    std::vector<std::unique_ptr<Shard>> shards;
+    unsigned long long shard_limit = 0;
+
+    // Disk katman: dosya ad anahtar ve kuaktan (generation) tretilir; her yazma yeni bir
+    // kuak aldndan silinmekte olan eski bir dosyann ad yeni dosyayla akmaz.
+    // LRU sras eriim sayacyla tutulur. disk_mtx yalnzca indeksi korur, dosya ilemleri
+    // kilit dnda yaplr.
+    struct DiskEntry {
+        unsigned long long size;
+        unsigned long long tick;
+        unsigned long long generation;
+    };
+    std::mutex disk_mtx;
+    std::unordered_map<unsigned long long, DiskEntry> disk_files;
+    std::map<unsigned long long, unsigned long long> disk_order;   // sra -> anahtar
+    unsigned long long disk_tick = 0;
+    unsigned long long disk_bytes = 0;
+    unsigned long long disk_generation = 0;
+
+    // Arka plan disk yazcs; kuyruk dolarsa yeni girdiler diske yazlmadan braklr
+    std::mutex write_mtx;
+    std::condition_variable write_cv;
+    std::deque<std::pair<unsigned long long, ChartBytes>> write_queue;
+    std::unordered_set<unsigned long long> write_pending;
+    unsigned long long write_queue_bytes = 0;
+    bool write_stop = false;
+    std::thread writer;
+
+    std::atomic<unsigned long long> memory_hits{ 0 }, disk_hits{ 0 }, misses{ 0 }, evictions{ 0 };
+
+    Shard& ShardFor(unsigned long long key) { return *shards[(key >> 48) % shards.size()]; }
+    void PutMemory(unsigned long long key, const ChartBytes& bytes);
+    bool GetDisk(unsigned long long key, ChartBytes& out);
+    void PutDisk(unsigned long long key, const ChartBytes& bytes);
+    void DiskWriter();
+    void WriteDisk(unsigned long long key, const ChartBytes& bytes);
+    void TouchDisk(unsigned long long key, unsigned long long size, unsigned long long generation);
+    bool DropDisk(unsigned long long key, unsigned long long tick, unsigned long long& generation);
+    std::string DiskPath(unsigned long long key, unsigned long long generation) const;
+public:
+    explicit ChartCache(const ChartCacheConfig& config);
+    ~ChartCache();      // kuyruktaki disk yazmalar bitirilir
+    ChartCache(const ChartCache&) = delete;
+    ChartCache& operator=(const ChartCache&) = delete;
+
+    // Bulunursa true dner; diskten okunan girdi bellek katmanna da alnr.
+    // Ayn istee ikinci bakta (r. kuyruktan sonra) count_miss false verilir, skalama iki kez saylmaz.
+    bool Get(unsigned long long key, ChartBytes& out, bool count_miss = true);
+    void Put(unsigned long long key, const ChartBytes& bytes);
+    ChartCacheStats Stats();
+};
@@ -0,0 +1,123 @@
+// ChartLoadGen.cpp
+// ChartService iin yk retici. Her balant cevap beklemeden depth kadar
+// istek gnderir, her cevapta yeni bir istek ekler.
+#include "ChartNet.h"   // winsock2.h windows.h'den nce gelmeli
+#include "ChartService.h"
+#include "ChartProtocol.h"
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+
+typedef std::chrono::steady_clock LoadClock;
+
+// Gsterge panelleri snrl sayda farkl grafik ister; ykte de cfg.distinct varyant dnml
+// kullanlr. Varyantlar dilim oranlaryla ayrtndan her biri ayr bir nbellek anahtardr.
+static ChartSpec SampleSpec(unsigned long long sequence, const ChartLoadConfig& cfg) {
+    ChartSpec spec;
+    spec.title = "Departman Harcama Dagilimi";
+    spec.width = cfg.width;
+    spec.height = cfg.height;
+    double v = static_cast<double>(cfg.distinct > 0 ? sequence % cfg.distinct : sequence);
+    spec.data = {
+        {"Ar-Ge", 25.0 + v},
+        {"Pazarlama", 30.0},
+        {"Uretim", 15.0 + v * 0.5},
+        {"Yonetim", 20.0},
+        {"Diger", 10.0}
+    };
+    return spec;
+}
+
+struct LoadResult {
+    std::vector<unsigned int> latencies;   // mikrosaniye
+    unsigned long long bytes = 0;
+    int errors = 0;
+};
+
+// first: bu balantnn ilk isteinin tm ykteki sras, varyantlar balantlar arasnda da dnsn
+static void LoadConnection(const ChartLoadConfig& cfg, int first, int count, LoadResult& res) {
+    SOCKET s = ChartConnect(cfg.port, cfg.unix_path);
+    if (s == INVALID_SOCKET) {
+        res.errors += count;
+        return;
+    }
+
+    std::vector<LoadClock::time_point> sent(count);
+    std::vector<unsigned char> out, payload;
+    res.latencies.reserve(count);
+    int next = 0, done = 0;
+
+    while (done < count) {
+        // Boalan yerleri tek bir send ile doldur
+        out.clear();
+        while (next < count && next - done < cfg.depth) {
+            SerializeChartRequest(static_cast<unsigned int>(next), SampleSpec(static_cast<unsigned long long>(first) + next, cfg), out);
+            sent[next] = LoadClock::now();
+            next++;
+        }
+        if (!out.empty() && !SendAll(s, out.data(), out.size())) break;
+
+        ChartResponseHeader h;
+        if (!RecvExact(s, &h, sizeof(h)) || h.magic != CHART_RES_MAGIC) break;
+        payload.resize(h.payload_len);
+        if (h.payload_len && !RecvExact(s, payload.data(), h.payload_len)) break;
+        done++;
+
+        if (h.status != CHART_STATUS_OK || h.request_id >= static_cast<unsigned int>(count)) {
+            res.errors++;
+            continue;
+        }
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(LoadClock::now() - sent[h.request_id]).count();
+        res.latencies.push_back(static_cast<unsigned int>(us));
+        res.bytes += h.payload_len;
+    }
+    res.errors += count - done;
+    closesocket(s);
+}
+
+int RunChartLoadGenerator(const ChartLoadConfig& cfg) {
+    if (cfg.connections < 1 || cfg.depth < 1 || cfg.requests < 1) {
+        printf("Gecersiz yuk parametreleri\n");
+        return 1;
+    }
+    if (!ChartNetStartup()) {
+        printf("WSAStartup basarisiz\n");
+        return 1;
+    }
+
+    std::vector<LoadResult> results(cfg.connections);
+    std::vector<std::thread> threads;
+    auto t0 = LoadClock::now();
+    int first = 0;
+    for (int i = 0; i < cfg.connections; i++) {
+        int share = cfg.requests / cfg.connections + (i < cfg.requests % cfg.connections ? 1 : 0);
+        threads.emplace_back(LoadConnection, std::cref(cfg), first, share, std::ref(results[i]));
+        first += share;
+    }
+    for (auto& t : threads) t.join();
+    double secs = std::chrono::duration<double>(LoadClock::now() - t0).count();
+
+    std::vector<unsigned int> all;
+    unsigned long long bytes = 0;
+    int errors = 0;
+    for (auto& r : results) {
+        all.insert(all.end(), r.latencies.begin(), r.latencies.end());
+        bytes += r.bytes;
+        errors += r.errors;
+    }
+    std::sort(all.begin(), all.end());
+
+    printf("%zu istek, %d hata, %.2f s\n", all.size(), errors, secs);
+    if (!all.empty()) {
+        printf("verim: %.0f istek/s, %.1f MB/s\n", all.size() / secs, bytes / secs / (1024.0 * 1024.0));
+        printf("gecikme: p50=%.2fms  p99=%.2fms  max=%.2fms\n",
+            all[all.size() / 2] / 1000.0, all[(all.size() * 99) / 100] / 1000.0, all.back() / 1000.0);
+    }
+
+    ChartNetCleanup();
+    return errors ? 2 : 0;
+}
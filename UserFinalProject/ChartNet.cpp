@@ -0,0 +1,135 @@
+// ChartNet.cpp
+#include "ChartNet.h"
+
+#include <algorithm>
+#include <cstring>
+
+bool ChartNetStartup() {
+    WSADATA wsa;
+    return WSAStartup(MAKEWORD(2, 2), &wsa) == 0;
+}
+
+void ChartNetCleanup() {
+    WSACleanup();
+}
+
+static int FillAddress(int port, const std::string& unix_path, sockaddr_storage& addr) {
+    memset(&addr, 0, sizeof(addr));
+    if (!unix_path.empty()) {
+        sockaddr_un* un = reinterpret_cast<sockaddr_un*>(&addr);
+        if (unix_path.size() >= sizeof(un->sun_path)) return 0;
+        un->sun_family = AF_UNIX;
+        memcpy(un->sun_path, unix_path.c_str(), unix_path.size() + 1);
+        return sizeof(sockaddr_un);
+    }
+    sockaddr_in* in = reinterpret_cast<sockaddr_in*>(&addr);
+    in->sin_family = AF_INET;
+    in->sin_port = htons(static_cast<u_short>(port));
+    in->sin_addr.s_addr = htonl(INADDR_LOOPBACK); // Sadece yerel makine
+    return sizeof(sockaddr_in);
+}
+
+SOCKET ChartListen(int port, const std::string& unix_path) {
+    sockaddr_storage addr;
+    int addr_len = FillAddress(port, unix_path, addr);
+    if (addr_len == 0) return INVALID_SOCKET;
+
+    SOCKET s = socket(addr.ss_family, SOCK_STREAM, 0);
+    if (s == INVALID_SOCKET) return s;
+
+    if (!unix_path.empty()) {
+        DeleteFileA(unix_path.c_str()); // nceki almadan kalan soket dosyas bind'i engeller
+    }
+    else {
+        BOOL excl = TRUE;
+        setsockopt(s, SOL_SOCKET, SO_EXCLUSIVEADDRUSE, reinterpret_cast<const char*>(&excl), sizeof(excl));
+    }
+
+    if (bind(s, reinterpret_cast<sockaddr*>(&addr), addr_len) == SOCKET_ERROR ||
+        listen(s, SOMAXCONN) == SOCKET_ERROR) {
+        closesocket(s);
+        return INVALID_SOCKET;
+    }
+    return s;
+}
+
+SOCKET ChartConnect(int port, const std::string& unix_path) {
+    sockaddr_storage addr;
+    int addr_len = FillAddress(port, unix_path, addr);
+    if (addr_len == 0) return INVALID_SOCKET;
+
+    SOCKET s = socket(addr.ss_family, SOCK_STREAM, 0);
+    if (s == INVALID_SOCKET) return s;
+
+    if (connect(s, reinterpret_cast<sockaddr*>(&addr), addr_len) == SOCKET_ERROR) {
+        closesocket(s);
+        return INVALID_SOCKET;
+    }
+    if (unix_path.empty()) {
+        BOOL nodelay = TRUE; // Kk istekler Nagle yznden bekletilmesin
+        setsockopt(s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&nodelay), sizeof(nodelay));
+    }
+    return s;
+}
+
+bool SendAll(SOCKET s, const void* data, size_t len) {
+    const char* p = static_cast<const char*>(data);
+    while (len > 0) {
+        int chunk = len > 0x40000000 ? 0x40000000 : static_cast<int>(len);
+        int n = send(s, p, chunk, 0);
+        if (n == SOCKET_ERROR || n == 0) return false;
+        p += n;
+        len -= n;
+    }
+    return true;
+}
+
+bool RecvExact(SOCKET s, void* data, size_t len) {
+    char* p = static_cast<char*>(data);
+    while (len > 0) {
+        int chunk = len > 0x40000000 ? 0x40000000 : static_cast<int>(len);
+        int n = recv(s, p, chunk, 0);
+        if (n == SOCKET_ERROR || n == 0) return false;
+        p += n;
+        len -= n;
+    }
+    return true;
+}
+
+int RecvSome(SOCKET s, std::vector<unsigned char>& buf, size_t max_chunk) {
+    size_t old_size = buf.size();
+    buf.resize(old_size + max_chunk);
+    int n = recv(s, reinterpret_cast<char*>(buf.data() + old_size), static_cast<int>(max_chunk), 0);
+    buf.resize(old_size + (n > 0 ? n : 0));
+    if (n == SOCKET_ERROR) return -1;
+    return n;
+}
+
+void LatencyStats::Record(unsigned int micros) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (samples.size() < LATENCY_WINDOW) samples.push_back(micros);
+    else samples[next] = micros;
+    next = (next + 1) % LATENCY_WINDOW;
+    total++;
+}
+
+unsigned long long LatencyStats::Snapshot(unsigned int& p50, unsigned int& p99, unsigned int& pmax) {
+    std::vector<unsigned int> copy;
+    unsigned long long count;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        copy = samples;
+        count = total;
+    }
+    p50 = p99 = pmax = 0;
+    if (copy.empty()) return count;
+
+    size_t i50 = copy.size() / 2;
+    size_t i99 = (copy.size() * 99) / 100;
+    std::nth_element(copy.begin(), copy.begin() + i50, copy.end());
+    p50 = copy[i50];
+    std::nth_element(copy.begin() + i50, copy.begin() + i99, copy.end());
+    p99 = copy[i99];
+    pmax = *std::max_element(copy.begin() + i99, copy.end());
+    return count;
+}
@@ -0,0 +1,39 @@
+// ChartNet.h
+// ChartService iin soket yardmclar ve gecikme istatistikleri.
+// winsock2.h, windows.h'den nce gelmelidir; bu bal icbytes.h'den nce ekleyin.
+#pragma once
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <afunix.h>
+
+#include <vector>
+#include <string>
+#include <mutex>
+
+bool ChartNetStartup();
+void ChartNetCleanup();
+
+// unix_path bosa 127.0.0.1:port, deilse AF_UNIX soketi aar.
+SOCKET ChartListen(int port, const std::string& unix_path);
+SOCKET ChartConnect(int port, const std::string& unix_path);
+
+bool SendAll(SOCKET s, const void* data, size_t len);
+bool RecvExact(SOCKET s, void* data, size_t len);
+// buf'un sonuna en fazla max_chunk bayt ekler. Dn: okunan bayt, balant kapandysa 0, hata ise -1.
+int RecvSome(SOCKET s, std::vector<unsigned char>& buf, size_t max_chunk);
+
+// Son LATENCY_WINDOW rnek zerinden p50/p99 hesaplar.  parac gvenlidir.
+#define LATENCY_WINDOW 65536
+
+class LatencyStats
+{
+    std::mutex mtx;
+    std::vector<unsigned int> samples;   // mikrosaniye
+    size_t next = 0;
+    unsigned long long total = 0;
+public:
+    LatencyStats() { samples.reserve(LATENCY_WINDOW); }
+    void Record(unsigned int micros);
+    // Dn: imdiye kadarki toplam rnek says
+    unsigned long long Snapshot(unsigned int& p50, unsigned int& p99, unsigned int& pmax);
+};
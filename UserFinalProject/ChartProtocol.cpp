@@ -0,0 +1,79 @@
+// ChartProtocol.cpp
+#include "ChartProtocol.h"
+
+#include <cstring>
+#include <cmath>
+
+static void PutBytes(std::vector<unsigned char>& out, const void* p, size_t n) {
+    const unsigned char* b = static_cast<const unsigned char*>(p);
+    out.insert(out.end(), b, b + n);
+}
+
+void SerializeChartRequest(unsigned int request_id, const ChartSpec& spec, std::vector<unsigned char>& out) {
+    size_t title_len = spec.title.size() > CHART_MAX_TEXT ? CHART_MAX_TEXT : spec.title.size();
+    size_t slice_count = spec.data.size() > CHART_MAX_SLICES ? CHART_MAX_SLICES : spec.data.size();
+
+    ChartRequestHeader h;
+    h.magic = CHART_REQ_MAGIC;
+    h.request_id = request_id;
+    h.width = static_cast<unsigned short>(spec.width);
+    h.height = static_cast<unsigned short>(spec.height);
+    h.title_len = static_cast<unsigned short>(title_len);
+    h.slice_count = static_cast<unsigned short>(slice_count);
+    PutBytes(out, &h, sizeof(h));
+    PutBytes(out, spec.title.data(), title_len);
+
+    for (size_t i = 0; i < slice_count; i++) {
+        const auto& item = spec.data[i];
+        size_t label_len = item.first.size() > CHART_MAX_TEXT ? CHART_MAX_TEXT : item.first.size();
+        ChartSliceHeader s;
+        s.value = item.second;
+        s.label_len = static_cast<unsigned short>(label_len);
+        PutBytes(out, &s, sizeof(s));
+        PutBytes(out, item.first.data(), label_len);
+    }
+}
+
+long long ParseChartRequest(const unsigned char* buf, size_t len, unsigned int& request_id, ChartSpec& spec) {
+    if (len < sizeof(ChartRequestHeader)) return 0;
+
+    ChartRequestHeader h;
+    memcpy(&h, buf, sizeof(h));
+    if (h.magic != CHART_REQ_MAGIC) return -1;
+    if (h.width < CHART_MIN_DIM || h.width > CHART_MAX_DIM) return -1;
+    if (h.height < CHART_MIN_DIM || h.height > CHART_MAX_DIM) return -1;
+    if (h.title_len > CHART_MAX_TEXT || h.slice_count > CHART_MAX_SLICES) return -1;
+
+    size_t pos = sizeof(h);
+    if (len < pos + h.title_len) return 0;
+    spec.title.assign(reinterpret_cast<const char*>(buf + pos), h.title_len);
+    pos += h.title_len;
+
+    spec.data.clear();
+    spec.data.reserve(h.slice_count);
+    for (int i = 0; i < h.slice_count; i++) {
+        if (len < pos + sizeof(ChartSliceHeader)) return 0;
+        ChartSliceHeader s;
+        memcpy(&s, buf + pos, sizeof(s));
+        pos += sizeof(s);
+        if (s.label_len > CHART_MAX_TEXT) return -1;
+        if (!std::isfinite(s.value) || s.value < 0.0) return -1; // Negatif, NaN ve sonsuz deerler pasta grafikte anlamsz
+        if (len < pos + s.label_len) return 0;
+        spec.data.emplace_back(std::string(reinterpret_cast<const char*>(buf + pos), s.label_len), s.value);
+        pos += s.label_len;
+    }
+
+    request_id = h.request_id;
+    spec.width = h.width;
+    spec.height = h.height;
+    return static_cast<long long>(pos);
+}
+
+PieLayout LayoutForSpec(const ChartSpec& spec) {
+    // GUI'deki 700x450 yerleimi (merkez 200, yarap 150) dier boyutlara oranlanr
+    PieLayout lay;
+    lay.radius = (spec.width < spec.height ? spec.width : spec.height) / 3;
+    lay.center_x = spec.width * 2 / 7;
+    lay.center_y = spec.height / 2 + 10;
+    return lay;
+}
@@ -0,0 +1,76 @@
+// ChartProtocol.h
+// ChartService ile istemcileri arasndaki ikili (binary) mesaj biimi.
+// Tm alanlar little-endian'dr. stemci cevap beklemeden birden fazla istek
+// gnderebilir (pipelining); cevaplar request_id ile eletirilir ve sras
+// isteklerin srasndan farkl olabilir.
+//
+//  stek : ChartRequestHeader | title (title_len bayt) | slice_count x (ChartSliceHeader | label)
+//  Cevap : ChartResponseHeader | payload (payload_len bayt, status OK ise BMP dosyas)
+#pragma once
+
+#include <vector>
+#include <string>
+#include <utility>
+
+#define CHART_REQ_MAGIC          0x51524349   // "ICRQ"
+#define CHART_RES_MAGIC          0x53524349   // "ICRS"
+
+#define CHART_MAX_SLICES         64
+#define CHART_MAX_TEXT           256
+#define CHART_MIN_DIM            64
+#define CHART_MAX_DIM            4096
+
+#define CHART_STATUS_OK              0
+#define CHART_STATUS_BAD_REQUEST     1
+#define CHART_STATUS_RENDER_FAILED   2
+
+#pragma pack(push, 1)
+struct ChartRequestHeader {
+    unsigned int magic;
+    unsigned int request_id;
+    unsigned short width;
+    unsigned short height;
+    unsigned short title_len;
+    unsigned short slice_count;
+};
+
+struct ChartSliceHeader {
+    double value;
+    unsigned short label_len;
+};
+
+struct ChartResponseHeader {
+    unsigned int magic;
+    unsigned int request_id;
+    unsigned int status;
+    unsigned int payload_len;
+};
+#pragma pack(pop)
+
+// Bir grafik isteinin ierii
+struct ChartSpec {
+    std::string title;
+    std::vector<std::pair<std::string, double>> data;
+    int width = 700;
+    int height = 450;
+};
+
+// stei mesaj biimine evirir ve out'un sonuna ekler.
+void SerializeChartRequest(unsigned int request_id, const ChartSpec& spec, std::vector<unsigned char>& out);
+
+// Tampondaki ilk istei zer.
+// Dn: tketilen bayt says, mesaj henz tamamlanmadysa 0, bozuksa -1.
+long long ParseChartRequest(const unsigned char* buf, size_t len, unsigned int& request_id, ChartSpec& spec);
+
+// Servisin izdii grafiklerin renkleri
+#define CHART_BACKCOLOR          0xFFFAFAFA
+#define CHART_TEXTCOLOR          0xFF000000
+
+struct PieLayout {
+    int center_x;
+    int center_y;
+    int radius;
+};
+
+// Grafik boyutuna gre pasta merkezini ve yarapn hesaplar.
+PieLayout LayoutForSpec(const ChartSpec& spec);
@@ -0,0 +1,401 @@
+// ChartService.cpp
+#include "ChartNet.h"   // winsock2.h windows.h'den nce gelmeli
+#include "ChartService.h"
+#include "ChartProtocol.h"
+#include "ChartCache.h"
+
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+typedef std::chrono::steady_clock ServiceClock;
+
+// Yazlmay bekleyen cevap. Yk nbellekteki baytlarla paylalr, kopyalanmaz.
+struct PendingResponse {
+    ChartResponseHeader header;
+    ChartBytes payload;
+    ServiceClock::time_point received;
+};
+
+// Bir istemci balants. Okuyucu, yazc i paracklar ve bu balantya ait
+// bekleyen iler tarafndan paylalr; soket son referans braklnca kapatlr.
+// iler cevaplar yalnzca outbox'a koyar, sokete yazan tek i parac yazcdr;
+// bylece yava okuyan bir istemci izim iilerini bekletmez.
+struct ChartConnection {
+    SOCKET sock;
+    std::mutex flow_mtx;                 // aadaki alanlar korur
+    std::condition_variable flow_cv;     // okuyucu: snrn altna inildi, yazc: yazlacak cevap var
+    std::deque<PendingResponse> outbox;
+    size_t pending_bytes = 0;            // outbox'taki ve yazlmakta olan cevap baytlar
+    int inflight = 0;                    // okunmu ama cevab henz yazlmam istekler
+    bool reader_done = false;
+    std::atomic<bool> closed{ false };
+
+    explicit ChartConnection(SOCKET s) : sock(s) {}
+    ~ChartConnection() { closesocket(sock); }
+};
+
+struct RenderJob {
+    std::shared_ptr<ChartConnection> conn;
+    unsigned int request_id = 0;
+    ChartSpec spec;
+    std::vector<PieSliceInfo> slices;
+    PieLayout lay;
+    unsigned long long key = 0;          // okuyucuda hesaplanr, nbellek ve toplu i iin
+    ServiceClock::time_point received;
+};
+
+// Snrl i kuyruu. Doluyken Push bekler; bylece balantlardan okuma durur
+// ve bask TCP penceresi zerinden istemciye geri yansr.
+class RenderQueue
+{
+    std::mutex mtx;
+    std::condition_variable not_empty, not_full;
+    std::deque<RenderJob> jobs;
+    size_t limit;
+    size_t workers;
+    bool stopping = false;
+public:
+    RenderQueue(size_t l, size_t w) : limit(l), workers(w) {}
+
+    bool Push(RenderJob&& job) {
+        std::unique_lock<std::mutex> lock(mtx);
+        not_full.wait(lock, [&] { return jobs.size() < limit || stopping; });
+        if (stopping) return false;
+        jobs.push_back(std::move(job));
+        not_empty.notify_one();
+        return true;
+    }
+
+    // En az bir i gelene kadar bekler, sonra en fazla max_jobs ii birlikte alr.
+    // Bir ii kuyruun en fazla 1/workers'n alr; dier iiler bota beklerken
+    // iler tek iide sraya girmesin.
+    bool PopBatch(std::vector<RenderJob>& batch, size_t max_jobs) {
+        batch.clear();
+        std::unique_lock<std::mutex> lock(mtx);
+        not_empty.wait(lock, [&] { return !jobs.empty() || stopping; });
+        if (jobs.empty()) return false;
+        size_t share = (jobs.size() + workers - 1) / workers;
+        if (max_jobs > share) max_jobs = share;
+        while (!jobs.empty() && batch.size() < max_jobs) {
+            batch.push_back(std::move(jobs.front()));
+            jobs.pop_front();
+        }
+        not_full.notify_all();
+        return true;
+    }
+
+    size_t Depth() {
+        std::lock_guard<std::mutex> lock(mtx);
+        return jobs.size();
+    }
+
+    void Stop() {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+        not_empty.notify_all();
+        not_full.notify_all();
+    }
+};
+
+struct ServiceState {
+    ChartServiceConfig cfg;
+    RenderQueue queue;
+    LatencyStats latency;
+    ChartCache cache;
+    std::atomic<unsigned long long> rendered{ 0 };
+    std::atomic<bool> running{ true };
+
+    ServiceState(const ChartServiceConfig& c, const ChartCacheConfig& cc) : cfg(c), queue(c.queue_limit, c.workers), cache(cc) {}
+};
+
+static SOCKET listen_socket_global = INVALID_SOCKET;
+
+static BOOL WINAPI ServiceCtrlHandler(DWORD ctrl) {
+    if (ctrl == CTRL_C_EVENT || ctrl == CTRL_BREAK_EVENT || ctrl == CTRL_CLOSE_EVENT) {
+        closesocket(listen_socket_global); // accept() dngsn sonlandrr
+        return TRUE;
+    }
+    return FALSE;
+}
+
+// Cevab balantnn yazcsna brakr, beklemez. Balant kapandysa cevap atlr.
+static void QueueResponse(ChartConnection& conn, unsigned int request_id, unsigned int status,
+    const ChartBytes& payload, ServiceClock::time_point received) {
+
+    PendingResponse r;
+    r.header.magic = CHART_RES_MAGIC;
+    r.header.request_id = request_id;
+    r.header.status = status;
+    r.header.payload_len = payload ? static_cast<unsigned int>(payload->size()) : 0;
+    r.payload = payload;
+    r.received = received;
+    {
+        std::lock_guard<std::mutex> lock(conn.flow_mtx);
+        if (conn.closed) {
+            conn.inflight--;
+        }
+        else {
+            conn.pending_bytes += sizeof(r.header) + r.header.payload_len;
+            conn.outbox.push_back(std::move(r));
+        }
+    }
+    conn.flow_cv.notify_all();
+}
+
+static bool IndexedMode(const ChartServiceConfig& cfg) {
+    return cfg.canvas_bits == CANVAS_4BIT || cfg.canvas_bits == CANVAS_8BIT;
+}
+
+// Dilimleri, yerleimi ve nbellek anahtarn hesaplar.
+static void PrepareJob(const ChartServiceConfig& cfg, RenderJob& job) {
+    const ChartSpec& spec = job.spec;
+    job.slices = BuildPieSlices(spec.data);
+    job.lay = LayoutForSpec(spec);
+    job.key = PieChartKey(job.slices, spec.title.c_str(), spec.width, spec.height,
+        job.lay.center_x, job.lay.center_y, job.lay.radius, CHART_BACKCOLOR, CHART_TEXTCOLOR,
+        IndexedMode(cfg) ? cfg.canvas_bits : 32);
+}
+
+static void RenderWorker(ServiceState& st) {
+    ICBYTES img; // Her iinin kendi tuvali vardr, ICBYTES nesneleri paylalmaz
+    bool indexed = IndexedMode(st.cfg);
+    std::unique_ptr<IndexedCanvas> canvas;
+    if (indexed) canvas = std::make_unique<IndexedCanvas>(st.cfg.canvas_bits);
+    std::vector<RenderJob> batch;
+    std::unordered_map<unsigned long long, ChartBytes> batch_results;
+
+    while (st.queue.PopBatch(batch, st.cfg.batch_size)) {
+        batch_results.clear();
+        for (RenderJob& job : batch) {
+            ChartBytes bytes;
+            if (!job.conn->closed) {
+                const ChartSpec& spec = job.spec;
+                const std::vector<PieSliceInfo>& slices = job.slices;
+                const PieLayout& lay = job.lay;
+                unsigned long long key = job.key;
+
+                // Ayn toplu iteki ayn grafik bir kez izilir (nbellek kapal olsa da);
+                // kuyruktayken baka bir iinin izdii grafik nbellekten dner.
+                auto done = batch_results.find(key);
+                if (done != batch_results.end()) {
+                    bytes = done->second;
+                }
+                else if (!st.cache.Get(key, bytes, false)) {
+                    std::shared_ptr<std::vector<unsigned char>> encoded = std::make_shared<std::vector<unsigned char>>();
+                    bool ok;
+                    if (indexed) {
+                        CreatePieChart(*canvas, slices, spec.title.c_str(), spec.width, spec.height,
+                            lay.center_x, lay.center_y, lay.radius, CHART_BACKCOLOR, CHART_TEXTCOLOR);
+                        ok = canvas->EncodeBMP(*encoded);
+                    }
+                    else {
+                        CreatePieChart(img, slices, spec.title.c_str(), spec.width, spec.height,
+                            lay.center_x, lay.center_y, lay.radius, CHART_BACKCOLOR, CHART_TEXTCOLOR);
+                        ok = EncodeBMP(img, *encoded);
+                    }
+                    if (ok) {
+                        bytes = encoded;
+                        st.cache.Put(key, bytes);
+                    }
+                    st.rendered++;
+                }
+                if (done == batch_results.end()) batch_results[key] = bytes;
+            }
+            QueueResponse(*job.conn, job.request_id, bytes ? CHART_STATUS_OK : CHART_STATUS_RENDER_FAILED, bytes, job.received);
+        }
+        batch.clear(); // balant referanslarn hemen brak
+    }
+}
+
+static void ReadRequests(const std::shared_ptr<ChartConnection>& conn, ServiceState& st) {
+    std::vector<unsigned char> buf;
+    size_t start = 0;
+    size_t pending_limit = static_cast<size_t>(st.cfg.max_pending_mb_per_conn) << 20;
+
+    for (;;) {
+        int n = RecvSome(conn->sock, buf, 64 * 1024);
+        if (n <= 0) break;
+
+        // Tampondaki tm tamamlanm istekleri sraya al (pipelining)
+        for (;;) {
+            unsigned int request_id = 0;
+            RenderJob job;
+            long long used = ParseChartRequest(buf.data() + start, buf.size() - start, request_id, job.spec);
+            if (used == 0) break;
+
+            // Balant bana snr: cevab bekleyen istek ya da yazlmam bayt oksa okumay durdur
+            {
+                std::unique_lock<std::mutex> lock(conn->flow_mtx);
+                conn->flow_cv.wait(lock, [&] {
+                    return (conn->inflight < st.cfg.max_inflight_per_conn && conn->pending_bytes < pending_limit) || conn->closed;
+                });
+                if (conn->closed) return;
+                conn->inflight++;
+            }
+
+            if (used < 0) {
+                // Hata cevab ve nceki isteklerin cevaplar yazldktan sonra balant kapanr
+                QueueResponse(*conn, 0, CHART_STATUS_BAD_REQUEST, nullptr, ServiceClock::now());
+                return;
+            }
+
+            job.conn = conn;
+            job.request_id = request_id;
+            job.received = ServiceClock::now();
+            start += static_cast<size_t>(used);
+
+            // nbellekteki grafik izim kuyruuna girmeden dorudan cevaplanr
+            PrepareJob(st.cfg, job);
+            ChartBytes cached;
+            if (st.cache.Get(job.key, cached)) {
+                QueueResponse(*conn, request_id, CHART_STATUS_OK, cached, job.received);
+                continue;
+            }
+            if (!st.queue.Push(std::move(job))) return;
+        }
+
+        buf.erase(buf.begin(), buf.begin() + start);
+        start = 0;
+    }
+}
+
+static void ConnectionReader(std::shared_ptr<ChartConnection> conn, std::shared_ptr<ServiceState> state) {
+    ReadRequests(conn, *state); // Ayrk (detached) i parac olduundan durum paylalr
+    // stemci gnderimi bitirdi; yazc bekleyen cevaplar gnderince kar ve soket kapanr.
+    {
+        std::lock_guard<std::mutex> lock(conn->flow_mtx);
+        conn->reader_done = true;
+    }
+    conn->flow_cv.notify_all();
+}
+
+// Balantnn outbox'n srayla sokete yazar. Engelleyen send() yalnzca bu
+// balantnn yazcsn bekletir; outbox bydke okuyucu yeni istek almaz.
+static void ConnectionWriter(std::shared_ptr<ChartConnection> conn, std::shared_ptr<ServiceState> state) {
+    for (;;) {
+        PendingResponse r;
+        {
+            std::unique_lock<std::mutex> lock(conn->flow_mtx);
+            conn->flow_cv.wait(lock, [&] {
+                return !conn->outbox.empty() || conn->closed || (conn->reader_done && conn->inflight == 0);
+            });
+            if (conn->closed || conn->outbox.empty()) break;
+            r = std::move(conn->outbox.front());
+            conn->outbox.pop_front();
+        }
+
+        size_t len = r.header.payload_len;
+        bool ok = SendAll(conn->sock, &r.header, sizeof(r.header)) && (len == 0 || SendAll(conn->sock, r.payload->data(), len));
+        {
+            std::lock_guard<std::mutex> lock(conn->flow_mtx);
+            conn->pending_bytes -= sizeof(r.header) + len;
+            conn->inflight--;
+            if (!ok) {
+                conn->closed = true;
+                conn->inflight -= static_cast<int>(conn->outbox.size());
+                conn->outbox.clear();
+                conn->pending_bytes = 0;
+            }
+        }
+        conn->flow_cv.notify_all();
+        if (!ok) {
+            shutdown(conn->sock, SD_BOTH); // recv'de bekleyen okuyucuyu uyandrr
+            break;
+        }
+
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(ServiceClock::now() - r.received).count();
+        state->latency.Record(static_cast<unsigned int>(us));
+    }
+}
+
+static void StatsReporter(ServiceState& st) {
+    unsigned long long last_count = 0;
+    auto last_time = ServiceClock::now();
+    while (st.running) {
+        for (int waited = 0; waited < st.cfg.stats_interval_ms && st.running; waited += 100) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        unsigned int p50, p99, pmax;
+        unsigned long long count = st.latency.Snapshot(p50, p99, pmax);
+        auto now = ServiceClock::now();
+        double secs = std::chrono::duration<double>(now - last_time).count();
+        if (count != last_count) {
+            ChartCacheStats cs = st.cache.Stats();
+            printf("[ChartService] %.0f istek/s  p50=%.2fms  p99=%.2fms  max=%.2fms  kuyruk=%zu  cizilen=%llu\n",
+                (count - last_count) / secs, p50 / 1000.0, p99 / 1000.0, pmax / 1000.0,
+                st.queue.Depth(), st.rendered.load());
+            printf("[ChartCache] bellek=%llu disk=%llu iskalama=%llu cikarilan=%llu  %.1fMB bellek, %.1fMB disk\n",
+                cs.memory_hits, cs.disk_hits, cs.misses, cs.evictions,
+                cs.memory_bytes / (1024.0 * 1024.0), cs.disk_bytes / (1024.0 * 1024.0));
+        }
+        last_count = count;
+        last_time = now;
+    }
+}
+
+int RunChartService(const ChartServiceConfig& config) {
+    ChartServiceConfig cfg = config;
+    if (cfg.workers <= 0) cfg.workers = static_cast<int>(std::thread::hardware_concurrency());
+    if (cfg.workers <= 0) cfg.workers = 4;
+    if (cfg.batch_size < 1) cfg.batch_size = 1;
+    if (cfg.queue_limit < 1) cfg.queue_limit = 1;
+    if (cfg.max_inflight_per_conn < 1) cfg.max_inflight_per_conn = 1;
+    if (cfg.max_pending_mb_per_conn < 1) cfg.max_pending_mb_per_conn = 1;
+
+    if (!ChartNetStartup()) {
+        printf("WSAStartup basarisiz\n");
+        return 1;
+    }
+
+    listen_socket_global = ChartListen(cfg.port, cfg.unix_path);
+    if (listen_socket_global == INVALID_SOCKET) {
+        printf("Soket dinlenemiyor (hata %d)\n", WSAGetLastError());
+        ChartNetCleanup();
+        return 1;
+    }
+    SetConsoleCtrlHandler(ServiceCtrlHandler, TRUE);
+
+    ChartCacheConfig cache_cfg;
+    cache_cfg.memory_limit = static_cast<unsigned long long>(cfg.cache_mb) << 20;
+    cache_cfg.disk_dir = cfg.cache_dir;
+    cache_cfg.disk_limit = static_cast<unsigned long long>(cfg.cache_disk_mb) << 20;
+
+    std::shared_ptr<ServiceState> state = std::make_shared<ServiceState>(cfg, cache_cfg);
+    ServiceState& st = *state;
+    std::vector<std::thread> workers;
+    for (int i = 0; i < cfg.workers; i++) workers.emplace_back(RenderWorker, std::ref(st));
+    std::thread stats;
+    if (cfg.stats_interval_ms > 0) stats = std::thread(StatsReporter, std::ref(st));
+
+    if (cfg.unix_path.empty()) printf("ChartService 127.0.0.1:%d dinleniyor, %d isci\n", cfg.port, cfg.workers);
+    else printf("ChartService %s dinleniyor, %d isci\n", cfg.unix_path.c_str(), cfg.workers);
+
+    for (;;) {
+        SOCKET c = accept(listen_socket_global, NULL, NULL);
+        if (c == INVALID_SOCKET) break;
+        if (cfg.unix_path.empty()) {
+            BOOL nodelay = TRUE;
+            setsockopt(c, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&nodelay), sizeof(nodelay));
+        }
+        std::shared_ptr<ChartConnection> conn = std::make_shared<ChartConnection>(c);
+        std::thread(ConnectionWriter, conn, state).detach();
+        std::thread(ConnectionReader, conn, state).detach();
+    }
+
+    st.running = false;
+    st.queue.Stop();
+    for (auto& w : workers) w.join();
+    if (stats.joinable()) stats.join();
+    if (!cfg.unix_path.empty()) DeleteFileA(cfg.unix_path.c_str());
+    ChartNetCleanup();
+    return 0;
+}
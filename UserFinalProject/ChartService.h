@@ -0,0 +1,39 @@
+// ChartService.h
+// Basz (GUI'siz) grafik izim servisi ve yk retici istemci.
+// Loopback TCP veya Windows AF_UNIX soketi zerinden ChartProtocol.h'deki
+// istekleri alr, izim havuzunda toplu (batch) olarak iler ve BMP dner.
+#pragma once
+
+#include <string>
+
+struct ChartServiceConfig {
+    int port = 5050;                 // unix_path bosa 127.0.0.1:port dinlenir
+    std::string unix_path;           // doluysa AF_UNIX soketi kullanlr
+    int workers = 0;                 // 0: ilemci says kadar
+    int batch_size = 16;             // bir iinin kuyruktan tek seferde ald en fazla i
+    int queue_limit = 1024;          // kuyruk dolunca balantlardan okuma durur (backpressure)
+    int max_inflight_per_conn = 64;  // bir balantnn cevab bekleyen en fazla istei
+    int max_pending_mb_per_conn = 16; // bir balantnn yazlmay bekleyen cevap bayt snr
+    int stats_interval_ms = 5000;    // p50/p99 raporlama aral, 0: kapal
+    int cache_mb = 256;              // bellek nbellei snr, 0: kapal
+    std::string cache_dir;           // doluysa izilen grafikler bu klasrde de saklanr
+    int cache_disk_mb = 1024;
+    int canvas_bits = 32;            // 4, 8 veya 32; 4 ve 8 paletli tuvale izip paletli BMP dner
+};
+
+struct ChartLoadConfig {
+    int port = 5050;
+    std::string unix_path;
+    int connections = 8;
+    int depth = 16;                  // balant bana cevap beklenmeden gnderilen istek says
+    int requests = 10000;            // toplam istek says
+    int distinct = 8;                // farkl grafik says, 0: her istek farkl (nbelleksiz izim lm)
+    int width = 700;
+    int height = 450;
+};
+
+// Servisi balatr ve kapatlana kadar (Ctrl+C) dner.
+int RunChartService(const ChartServiceConfig& cfg);
+
+// Servise yk uygular, verim ve gecikme yzdeliklerini yazdrr.
+int RunChartLoadGenerator(const ChartLoadConfig& cfg);
@@ -0,0 +1,22 @@
+// CpuFeatures.cpp
+#include "CpuFeatures.h"
+
+#include <intrin.h>
+
+// cpuid yaprak 1, ECX
+static int CpuidFeatureBits() {
+    static const int ecx = [] {
+        int info[4];
+        __cpuid(info, 1);
+        return info[2];
+    }();
+    return ecx;
+}
+
+bool HasSSSE3() {
+    return (CpuidFeatureBits() & (1 << 9)) != 0;
+}
+
+bool HasSSE42() {
+    return (CpuidFeatureBits() & (1 << 20)) != 0;
+}
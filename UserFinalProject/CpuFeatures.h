@@ -0,0 +1,7 @@
+// CpuFeatures.h
+// lemcinin destekledii SIMD komut kmeleri. Sonu ilk arda cpuid ile okunur ve saklanr;
+// SIMD yollar bunlarla seilir, desteklenmeyen ilemcide skaler yol kullanlr.
+#pragma once
+
+bool HasSSSE3();    // pshufb (IndexedCanvas palet geniletme)
+bool HasSSE42();    // crc32 (IcbPack CRC32C)
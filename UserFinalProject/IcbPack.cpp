@@ -0,0 +1,381 @@
+// IcbPack.cpp
+#include "IcbPack.h"
+#include "CpuFeatures.h"
+
+#include <nmmintrin.h>  // SSE4.2 CRC32C
+#include <cstring>
+#include <climits>
+#include <cstddef>
+
+static const char ICBPACK_MAGIC[8] = { 'I','C','B','P','A','C','K',0 };
+
+static_assert(sizeof(IcbPackHeader) == ICBPACK_ALIGN, "IcbPackHeader 64 bayt olmali");
+static_assert(sizeof(IcbPackEntry) % 8 == 0, "IcbPackEntry 8 baytin kati olmali");
+
+// SSE4.2 olmayan ilemciler iin tablo ile CRC32C (Castagnoli, yanstlm polinom)
+static unsigned int Crc32cTable(unsigned int crc, const unsigned char* p, size_t len) {
+    static const struct Table {
+        unsigned int t[256];
+        Table() {
+            for (unsigned int i = 0; i < 256; i++) {
+                unsigned int c = i;
+                for (int k = 0; k < 8; k++) c = (c >> 1) ^ (0x82F63B78u & (0u - (c & 1)));
+                t[i] = c;
+            }
+        }
+    } table;
+    while (len--) crc = table.t[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+// CRC32C; crc nceki parann sonucudur, bylece veri para para ilenebilir.
+static unsigned int Crc32c(unsigned int crc, const void* data, size_t len) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+    if (!HasSSE42()) return ~Crc32cTable(crc, p, len);
+#ifdef _M_X64
+    while (len >= 8) {
+        unsigned long long v;
+        memcpy(&v, p, 8);
+        crc = static_cast<unsigned int>(_mm_crc32_u64(crc, v));
+        p += 8;
+        len -= 8;
+    }
+#endif
+    while (len >= 4) {
+        unsigned int v;
+        memcpy(&v, p, 4);
+        crc = _mm_crc32_u32(crc, v);
+        p += 4;
+        len -= 4;
+    }
+    while (len--) crc = _mm_crc32_u8(crc, *p++);
+    return ~crc;
+}
+
+int IcbElementSize(unsigned type) {
+    switch (type) {
+    case ICB_CHAR: case ICB_UCHAR: return 1;
+    case ICB_SHORT: case ICB_USHORT: return 2;
+    case ICB_INT: case ICB_UINT: case ICB_FLOAT: return 4;
+    case ICB_LONGLONG: case ICB_ULONGLONG: case ICB_DOUBLE: return 8;
+    }
+    return 0;
+}
+
+// (1, y, z) elemannn adresi; her satr bellekte ardktr.
+static unsigned char* RowPointer(ICBYTES& m, long long y, int z) {
+    switch (GetType(m)) {
+    case ICB_CHAR: case ICB_UCHAR: return &m.B(1, y, z);
+    case ICB_SHORT: case ICB_USHORT: return reinterpret_cast<unsigned char*>(&m.u(1, y, z));
+    case ICB_INT: case ICB_UINT: return reinterpret_cast<unsigned char*>(&m.U(1, y, z));
+    case ICB_FLOAT: return reinterpret_cast<unsigned char*>(&m.F(1, y, z));
+    case ICB_LONGLONG: case ICB_ULONGLONG: return reinterpret_cast<unsigned char*>(&m.O(1, y, z));
+    case ICB_DOUBLE: return reinterpret_cast<unsigned char*>(&m.D(1, y, z));
+    }
+    return nullptr;
+}
+
+// ndeks [index_offset, index_offset + count girdi) aral header ile end arasna syor mu
+static bool ValidIndexRange(unsigned long long index_offset, unsigned long long count, unsigned long long end) {
+    return index_offset % ICBPACK_ALIGN == 0 && index_offset >= sizeof(IcbPackHeader) && index_offset <= end &&
+        count <= (end - index_offset) / sizeof(IcbPackEntry);
+}
+
+static unsigned int HeaderChecksum(const IcbPackHeader& h) {
+    return Crc32c(0, &h, offsetof(IcbPackHeader, header_checksum));
+}
+
+static bool ValidHeader(const IcbPackHeader& h, unsigned long long file_size) {
+    return memcmp(h.magic, ICBPACK_MAGIC, 8) == 0 && h.version == ICBPACK_VERSION &&
+        h.header_size == sizeof(h) && h.header_checksum == HeaderChecksum(h) &&
+        ValidIndexRange(h.index_offset, h.index_count, file_size);
+}
+
+static bool ValidEntry(const IcbPackEntry& e, unsigned long long data_end) {
+    if (e.name[ICBPACK_NAME_LEN - 1] != 0) return false;
+    if (e.elem_size == 0 || static_cast<int>(e.elem_size) != IcbElementSize(e.type)) return false;
+    if (e.x < 1 || e.y < 1 || e.z < 1 || e.w < 1) return false;
+    // arpmlar ve toplamlar tamayacak biimde karlatrlr; bozuk bir girdi elemenin dn gstermemeli
+    if (e.x > LLONG_MAX / e.elem_size || e.stride_y < e.x * static_cast<long long>(e.elem_size)) return false;
+    if (e.y > LLONG_MAX / e.stride_y || e.stride_z < e.stride_y * e.y) return false;
+    if (e.z > LLONG_MAX / e.stride_z || e.stride_w < e.stride_z * e.z) return false;
+    if (e.w > LLONG_MAX / e.stride_w || static_cast<unsigned long long>(e.stride_w * e.w) != e.length) return false;
+    if (e.offset % ICBPACK_ALIGN != 0) return false;
+    return e.offset >= sizeof(IcbPackHeader) && e.offset <= data_end && e.length <= data_end - e.offset;
+}
+
+//------------------------------------ READER ------------------------------------
+
+bool IcbPackReader::Open(const char* filepath) {
+    Close();
+    // Yazc dosyann sonuna eklerken de alabilsin; elenen grnt al anndaki indeksle snrldr
+    file = CreateFileA(filepath, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fsize;
+    if (!GetFileSizeEx(file, &fsize) ||
+        static_cast<unsigned long long>(fsize.QuadPart) < sizeof(IcbPackHeader)) {
+        Close();
+        return false;
+    }
+    size = fsize.QuadPart;
+
+    mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping == NULL) {
+        Close();
+        return false;
+    }
+    base = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (base == nullptr) {
+        Close();
+        return false;
+    }
+
+    // Balk yazc tarafndan gncellenebileceinden nce kopyalanr, sonra dorulanr
+    IcbPackHeader h;
+    memcpy(&h, base, sizeof(h));
+    if (!ValidHeader(h, size)) {
+        Close();
+        return false;
+    }
+
+    entries = reinterpret_cast<const IcbPackEntry*>(base + h.index_offset);
+    if (Crc32c(0, entries, h.index_count * sizeof(IcbPackEntry)) != h.index_checksum) {
+        Close();
+        return false;
+    }
+    for (unsigned int i = 0; i < h.index_count; i++) {
+        if (!ValidEntry(entries[i], h.index_offset)) {
+            Close();
+            return false;
+        }
+    }
+    count = h.index_count;
+    return true;
+}
+
+void IcbPackReader::Close() {
+    if (base) UnmapViewOfFile(base);
+    if (mapping) CloseHandle(mapping);
+    if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+    base = nullptr;
+    mapping = NULL;
+    file = INVALID_HANDLE_VALUE;
+    entries = nullptr;
+    count = 0;
+    size = 0;
+}
+
+bool IcbPackReader::At(unsigned int index, IcbView& view) const {
+    if (index >= count) return false;
+    view.entry = &entries[index];
+    view.data = base + entries[index].offset;
+    return true;
+}
+
+bool IcbPackReader::Find(const char* name, IcbView& view) const {
+    for (unsigned int i = count; i-- > 0;) {
+        if (strcmp(entries[i].name, name) == 0) return At(i, view);
+    }
+    return false;
+}
+
+bool IcbPackReader::Verify(const IcbView& view) const {
+    if (!view.entry) return false;
+    return Crc32c(0, view.data, static_cast<size_t>(view.entry->length)) == view.entry->checksum;
+}
+
+bool CopyToICBYTES(const IcbView& view, ICBYTES& out) {
+    const IcbPackEntry* e = view.entry;
+    if (!e || e->w != 1) return false;
+
+    if (e->z > 1) CreateMatrix(out, e->x, e->y, static_cast<int>(e->z), static_cast<int>(e->type));
+    else CreateMatrix(out, e->x, e->y, static_cast<int>(e->type));
+
+    size_t row_bytes = static_cast<size_t>(e->x * e->elem_size);
+    for (long long z = 1; z <= e->z; z++) {
+        for (long long y = 1; y <= e->y; y++) {
+            unsigned char* dst = RowPointer(out, y, static_cast<int>(z));
+            if (!dst) return false;
+            memcpy(dst, view.Row<unsigned char>(y, z), row_bytes);
+        }
+    }
+    return true;
+}
+
+//------------------------------------ WRITER ------------------------------------
+
+bool IcbPackWriter::WriteRaw(const void* p, size_t n) {
+    const char* c = static_cast<const char*>(p);
+    while (n > 0) {
+        DWORD chunk = n > 0x40000000 ? 0x40000000 : static_cast<DWORD>(n);
+        DWORD written = 0;
+        if (!WriteFile(file, c, chunk, &written, NULL) || written == 0) return false;
+        c += written;
+        n -= written;
+        pos += written;
+    }
+    return true;
+}
+
+bool IcbPackWriter::PadTo(unsigned long long alignment) {
+    static const unsigned char zeros[ICBPACK_ALIGN] = {};
+    size_t pad = static_cast<size_t>((alignment - pos % alignment) % alignment);
+    return pad == 0 || WriteRaw(zeros, pad);
+}
+
+// Bal dosyann bana yazar, ardndan dosya iaretisini pos'a geri alr.
+bool IcbPackWriter::WriteHeader(unsigned long long index_offset, unsigned int index_count, unsigned int index_checksum) {
+    IcbPackHeader h = {};
+    memcpy(h.magic, ICBPACK_MAGIC, 8);
+    h.version = ICBPACK_VERSION;
+    h.header_size = sizeof(h);
+    h.index_offset = index_offset;
+    h.index_count = index_count;
+    h.index_checksum = index_checksum;
+    h.header_checksum = HeaderChecksum(h);
+
+    LARGE_INTEGER off;
+    off.QuadPart = 0;
+    DWORD written = 0;
+    bool ok = SetFilePointerEx(file, off, NULL, FILE_BEGIN) && WriteFile(file, &h, sizeof(h), &written, NULL) &&
+        written == sizeof(h);
+    off.QuadPart = static_cast<long long>(pos);
+    return SetFilePointerEx(file, off, NULL, FILE_BEGIN) && ok;
+}
+
+bool IcbPackWriter::Open(const char* filepath, bool truncate) {
+    Close();
+    file = CreateFileA(filepath, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL,
+        truncate ? CREATE_ALWAYS : OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fsize;
+    if (!GetFileSizeEx(file, &fsize)) {
+        Close();
+        return false;
+    }
+
+    if (fsize.QuadPart == 0) {
+        // Bo paket: indeks baln hemen arkasnda ve girdisiz
+        pos = sizeof(IcbPackHeader);
+        if (!WriteHeader(sizeof(IcbPackHeader), 0, Crc32c(0, nullptr, 0)) || !FlushFileBuffers(file)) {
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    // Mevcut paket: baln gsterdii indeksi oku, yeni veriler dosyann sonuna eklenecek.
+    // nceki yarm kalm eklemelerin artklar sonda l alan olarak kalr.
+    IcbPackHeader h;
+    DWORD got = 0;
+    LARGE_INTEGER off;
+    bool ok = ReadFile(file, &h, sizeof(h), &got, NULL) && got == sizeof(h) &&
+        ValidHeader(h, fsize.QuadPart) &&
+        static_cast<unsigned long long>(h.index_count) * sizeof(IcbPackEntry) <= MAXDWORD;
+    if (ok) {
+        index.resize(h.index_count);
+        off.QuadPart = h.index_offset;
+        DWORD bytes = static_cast<DWORD>(h.index_count * sizeof(IcbPackEntry));
+        ok = SetFilePointerEx(file, off, NULL, FILE_BEGIN) &&
+            (bytes == 0 || (ReadFile(file, index.data(), bytes, &got, NULL) && got == bytes)) &&
+            Crc32c(0, index.data(), bytes) == h.index_checksum;
+        for (size_t i = 0; ok && i < index.size(); i++) ok = ValidEntry(index[i], h.index_offset);
+    }
+    if (!ok) {
+        index.clear();
+        Close();
+        return false;
+    }
+
+    loaded = index.size();
+    off.QuadPart = 0;
+    SetFilePointerEx(file, off, NULL, FILE_END);
+    pos = fsize.QuadPart;
+    return true;
+}
+
+bool IcbPackWriter::BeginEntry(const char* name, unsigned type, long long x, long long y, long long z, long long w) {
+    if (file == INVALID_HANDLE_VALUE || in_entry) return false;
+    int elem = IcbElementSize(type);
+    if (elem == 0 || x < 1 || y < 1 || z < 1 || w < 1 || strlen(name) >= ICBPACK_NAME_LEN) return false;
+    if (!PadTo(ICBPACK_ALIGN)) return false;
+
+    memset(&current, 0, sizeof(current));
+    strcpy_s(current.name, sizeof(current.name), name);
+    current.type = type;
+    current.elem_size = elem;
+    current.x = x;
+    current.y = y;
+    current.z = z;
+    current.w = w;
+    current.stride_y = x * elem;
+    current.stride_z = current.stride_y * y;
+    current.stride_w = current.stride_z * z;
+    current.offset = pos;
+    crc = 0;
+    in_entry = true;
+    return true;
+}
+
+bool IcbPackWriter::WriteChunk(const void* data, size_t len) {
+    if (!in_entry) return false;
+    unsigned long long written = pos - current.offset;
+    if (written + len > static_cast<unsigned long long>(current.stride_w * current.w)) return false;
+    crc = Crc32c(crc, data, len);
+    return WriteRaw(data, len);
+}
+
+bool IcbPackWriter::EndEntry() {
+    if (!in_entry) return false;
+    in_entry = false;
+    current.length = pos - current.offset;
+    if (current.length != static_cast<unsigned long long>(current.stride_w * current.w)) return false; // eksik veri: girdi indekslenmez
+    current.checksum = crc;
+    index.push_back(current);
+    return true;
+}
+
+bool IcbPackWriter::Append(const char* name, ICBYTES& m) {
+    if (m.W() > 1) return false;
+    unsigned type = GetType(m);
+    long long z_count = m.Z() > 0 ? m.Z() : 1;
+    if (!BeginEntry(name, type, m.X(), m.Y(), z_count)) return false;
+
+    size_t row_bytes = static_cast<size_t>(current.stride_y);
+    for (long long z = 1; z <= z_count; z++) {
+        for (long long y = 1; y <= m.Y(); y++) {
+            unsigned char* row = RowPointer(m, y, static_cast<int>(z));
+            if (!row || !WriteChunk(row, row_bytes)) {
+                in_entry = false;
+                return false;
+            }
+        }
+    }
+    return EndEntry();
+}
+
+bool IcbPackWriter::Close() {
+    if (file == INVALID_HANDLE_VALUE) return true;
+    in_entry = false; // bitmemi girdi braklr
+
+    bool ok = true;
+    if (index.size() != loaded) {
+        // nce veriler ve yeni indeks diske aktarlr, sonra balk ona evrilir.
+        // Bu srada kesilirse balk nceki indeksi gstermeye devam eder.
+        size_t index_bytes = index.size() * sizeof(IcbPackEntry);
+        ok = PadTo(ICBPACK_ALIGN);
+        unsigned long long index_offset = pos;
+        ok = ok && WriteRaw(index.data(), index_bytes) && FlushFileBuffers(file);
+        ok = ok && WriteHeader(index_offset, static_cast<unsigned int>(index.size()), Crc32c(0, index.data(), index_bytes)) &&
+            FlushFileBuffers(file);
+    }
+    CloseHandle(file);
+    file = INVALID_HANDLE_VALUE;
+    index.clear();
+    loaded = 0;
+    pos = 0;
+    return ok;
+}
@@ -0,0 +1,131 @@
+// IcbPack.h
+// Birden fazla isimli ICBYTES matrisini tek dosyada tutan srml kap biimi.
+// Okuma taraf dosyay salt okunur olarak bellee eler (memory-mapped);
+// matrisler kopyalanmadan IcbView zerinden dorudan kullanlr.
+//
+//  [IcbPackHeader] [veri 0] [veri 1] ... [IcbPackEntry x n]
+//
+// Her veri blou ICBPACK_ALIGN snrndan balar. Geerli indeksin yeri balkta
+// tutulur. Ekleme yaplrken mevcut veriler yeniden yazlmaz; yeni veriler ve
+// gncel indeks dosyann sonuna yazlp diske aktarldktan sonra balk yeni
+// indeksi gsterecek ekilde gncellenir. Yarda kalan bir ekleme bal
+// deitirmediinden nceki indeks geerli kalr; eski indeks ve yarm kalan
+// veriler l alan olarak kalr.
+#pragma once
+#include "icbytes.h"
+
+#include <vector>
+#include <string>
+
+#define ICBPACK_VERSION      2
+#define ICBPACK_ALIGN        64
+#define ICBPACK_NAME_LEN     64
+
+#pragma pack(push, 1)
+struct IcbPackHeader {
+    char magic[8];                  // "ICBPACK"
+    unsigned int version;
+    unsigned int header_size;
+    unsigned long long index_offset; // geerli indeks
+    unsigned int index_count;
+    unsigned int index_checksum;    // indeksin CRC32C'si
+    unsigned int header_checksum;   // bu alana kadarki baytlarn CRC32C'si, yarm yazlm bal yakalar
+    unsigned char reserved[28];
+};
+
+struct IcbPackEntry {
+    char name[ICBPACK_NAME_LEN];    // sfr ile biten isim
+    unsigned int type;              // ICB_UCHAR, ICB_UINT, ICB_DOUBLE ...
+    unsigned int elem_size;
+    long long x, y, z, w;
+    long long stride_y, stride_z, stride_w;   // bayt cinsinden
+    unsigned long long offset;      // dosya bandan itibaren
+    unsigned long long length;
+    unsigned int checksum;          // verinin CRC32C'si
+    unsigned int reserved;
+};
+#pragma pack(pop)
+
+// Elenmi dosyadaki bir matrise salt okunur bak. ndeksler ICBYTES gibi 1'den balar.
+struct IcbView {
+    const IcbPackEntry* entry = nullptr;
+    const unsigned char* data = nullptr;
+
+    long long X() const { return entry->x; }
+    long long Y() const { return entry->y; }
+    long long Z() const { return entry->z; }
+    long long W() const { return entry->w; }
+    unsigned Type() const { return entry->type; }
+
+    template <class T> const T& At(long long x, long long y = 1, long long z = 1) const {
+        return *reinterpret_cast<const T*>(data + (x - 1) * sizeof(T) + (y - 1) * entry->stride_y + (z - 1) * entry->stride_z);
+    }
+    template <class T> const T* Row(long long y, long long z = 1) const {
+        return reinterpret_cast<const T*>(data + (y - 1) * entry->stride_y + (z - 1) * entry->stride_z);
+    }
+};
+
+// Eleman boyutu (bayt); desteklenmeyen tiplerde 0.
+int IcbElementSize(unsigned type);
+
+// Salt okunur, bellee elenmi paket dosyas.
+class IcbPackReader
+{
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = NULL;
+    const unsigned char* base = nullptr;
+    unsigned long long size = 0;
+    const IcbPackEntry* entries = nullptr;
+    unsigned int count = 0;
+public:
+    IcbPackReader() {}
+    ~IcbPackReader() { Close(); }
+    IcbPackReader(const IcbPackReader&) = delete;
+    IcbPackReader& operator=(const IcbPackReader&) = delete;
+
+    // Balk ve indeks dorulanr; paket baka bir srete eklemeye akken de okunabilir; veri sayfalar ilk eriime kadar okunmaz.
+    bool Open(const char* filepath);
+    void Close();
+
+    unsigned int Count() const { return count; }
+    bool At(unsigned int index, IcbView& view) const;
+    // Ayn isim birden ok kez eklenmise en son eklenen dner.
+    bool Find(const char* name, IcbView& view) const;
+    // Verinin tamamn okuyup CRC32C'sini karlatrr.
+    bool Verify(const IcbView& view) const;
+};
+
+// ICBYTES'a kopyalar; ICBYTES tamponunu kendisi ynettii iin sfr kopya mmkn deildir.
+bool CopyToICBYTES(const IcbView& view, ICBYTES& out);
+
+// Paket dosyasna ekleme yapar. Close arlana kadar yeni girdiler okuyuculara grnmez.
+class IcbPackWriter
+{
+    HANDLE file = INVALID_HANDLE_VALUE;
+    std::vector<IcbPackEntry> index;
+    size_t loaded = 0;              // dosyada zaten indekslenmi girdi says
+    unsigned long long pos = 0;
+    bool in_entry = false;
+    IcbPackEntry current;
+    unsigned int crc = 0;
+
+    bool WriteRaw(const void* p, size_t n);
+    bool PadTo(unsigned long long alignment);
+    bool WriteHeader(unsigned long long index_offset, unsigned int index_count, unsigned int index_checksum);
+public:
+    IcbPackWriter() {}
+    ~IcbPackWriter() { Close(); }
+    IcbPackWriter(const IcbPackWriter&) = delete;
+    IcbPackWriter& operator=(const IcbPackWriter&) = delete;
+
+    // Dosya yoksa yaratlr; varsa mevcut indeks korunur (truncate ise silinir).
+    bool Open(const char* filepath, bool truncate = false);
+    // ICBYTES matrisini tek seferde ekler.
+    bool Append(const char* name, ICBYTES& m);
+    // Ak halinde ekleme: BeginEntry, ardndan toplam x*y*z*w eleman kadar WriteChunk, sonra EndEntry.
+    bool BeginEntry(const char* name, unsigned type, long long x, long long y = 1, long long z = 1, long long w = 1);
+    bool WriteChunk(const void* data, size_t len);
+    bool EndEntry();
+    // ndeksi yazar, diske aktarr ve ardndan bal yeni indeksi gsterecek ekilde gnceller.
+    bool Close();
+};
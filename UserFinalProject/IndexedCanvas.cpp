@@ -0,0 +1,391 @@
+// IndexedCanvas.cpp
+#include "IndexedCanvas.h"
+#include "CpuFeatures.h"
+#include "Raster.h"
+#include "ic_media.h"
+
+#include <tmmintrin.h>  // SSSE3 _mm_shuffle_epi8
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+IndexedCanvas::IndexedCanvas(int bits_per_pixel) : bits(bits_per_pixel == CANVAS_4BIT ? CANVAS_4BIT : CANVAS_8BIT) {
+    memset(palette, 0, sizeof(palette));
+}
+
+bool IndexedCanvas::Create(int w, int h, unsigned int backcolor) {
+    if (w <= 0 || h <= 0) return false;
+    width = w;
+    height = h;
+    stride = ((w * bits + 7) / 8 + 3) & ~3;
+    pixels.assign(static_cast<size_t>(stride) * h, 0);
+    palette_size = 0;
+    Clear(backcolor);
+    return true;
+}
+
+int IndexedCanvas::ColorIndex(unsigned int argb) {
+    for (int i = 0; i < palette_size; i++) {
+        if (palette[i] == argb) return i;
+    }
+    if (palette_size < (1 << bits)) {
+        palette[palette_size] = argb;
+        return palette_size++;
+    }
+
+    // Palet dolu: en yakn rengi kullan
+    int best = 0;
+    long long best_d = -1;
+    for (int i = 0; i < palette_size; i++) {
+        long long d = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            int c = static_cast<int>((palette[i] >> shift) & 0xFF) - static_cast<int>((argb >> shift) & 0xFF);
+            d += c * c;
+        }
+        if (best_d < 0 || d < best_d) {
+            best_d = d;
+            best = i;
+        }
+    }
+    return best;
+}
+
+int IndexedCanvas::GetIndex(int x, int y) const {
+    if (x < 0 || y < 0 || x >= width || y >= height) return -1;
+    const unsigned char* row = Row(y);
+    if (bits == CANVAS_8BIT) return row[x];
+    return (x & 1) ? (row[x >> 1] & 0x0F) : (row[x >> 1] >> 4);
+}
+
+void IndexedCanvas::Put(int x, int y, int index) {
+    if (x < 0 || y < 0 || x >= width || y >= height) return;
+    unsigned char* row = pixels.data() + static_cast<size_t>(y) * stride;
+    if (bits == CANVAS_8BIT) {
+        row[x] = static_cast<unsigned char>(index);
+    }
+    else if (x & 1) {
+        row[x >> 1] = static_cast<unsigned char>((row[x >> 1] & 0xF0) | index);
+    }
+    else {
+        row[x >> 1] = static_cast<unsigned char>((row[x >> 1] & 0x0F) | (index << 4));
+    }
+}
+
+// [x0, x1) aral, krplm olmal
+void IndexedCanvas::FillSpan(int x0, int x1, int y, int index) {
+    unsigned char* row = pixels.data() + static_cast<size_t>(y) * stride;
+    if (bits == CANVAS_8BIT) {
+        memset(row + x0, index, x1 - x0);
+        return;
+    }
+    // 4 bit: kenarlardaki yarm baytlar tek tek, ortas bayt bayt
+    if (x0 & 1 && x0 < x1) Put(x0++, y, index);
+    if (x1 & 1 && x0 < x1) Put(--x1, y, index);
+    if (x0 < x1) memset(row + (x0 >> 1), index * 0x11, (x1 - x0) >> 1);
+}
+
+// [x0, x1] aral, tuval dna taan ksm krplr
+void IndexedCanvas::Span(int x0, int x1, int y, int index) {
+    if (y < 0 || y >= height) return;
+    if (x0 < 0) x0 = 0;
+    if (x1 >= width) x1 = width - 1;
+    if (x0 <= x1) FillSpan(x0, x1 + 1, y, index);
+}
+
+void IndexedCanvas::VSpan(int x, int y0, int y1, int index) {
+    if (x < 0 || x >= width) return;
+    if (y0 < 0) y0 = 0;
+    if (y1 >= height) y1 = height - 1;
+    for (int y = y0; y <= y1; y++) Put(x, y, index);
+}
+
+void IndexedCanvas::Clear(unsigned int color) {
+    int index = ColorIndex(color);
+    unsigned char fill = static_cast<unsigned char>(bits == CANVAS_8BIT ? index : index * 0x11);
+    memset(pixels.data(), fill, pixels.size());
+}
+
+void IndexedCanvas::FillRect(int x, int y, int w, int h, unsigned int color) {
+    int x0 = x < 0 ? 0 : x, x1 = x + w > width ? width : x + w;
+    int y0 = y < 0 ? 0 : y, y1 = y + h > height ? height : y + h;
+    if (x0 >= x1 || y0 >= y1) return;
+    int index = ColorIndex(color);
+    for (int yy = y0; yy < y1; yy++) FillSpan(x0, x1, yy, index);
+}
+
+void IndexedCanvas::Line(int x1, int y1, int x2, int y2, unsigned int color) {
+    int index = ColorIndex(color);
+    RasterLine(x1, y1, x2, y2, [&](int x, int y) { Put(x, y, index); });
+}
+
+void IndexedCanvas::Rect(int x, int y, int w, int h, unsigned int color) {
+    if (w <= 0 || h <= 0) return;
+    int index = ColorIndex(color);
+    Span(x, x + w - 1, y, index);
+    Span(x, x + w - 1, y + h - 1, index);
+    VSpan(x, y + 1, y + h - 2, index);
+    VSpan(x + w - 1, y + 1, y + h - 2, index);
+}
+
+void IndexedCanvas::FillRoundRect(int x, int y, int w, int h, int r, unsigned int color) {
+    if (w <= 0 || h <= 0) return;
+    r = r < 0 ? 0 : r;
+    r = r > w / 2 ? w / 2 : r;
+    r = r > h / 2 ? h / 2 : r;
+    int index = ColorIndex(color);
+    for (int row = 0; row < h; row++) {
+        // Ke yaylarnn bulunduu satrlarda satr yay kadar ieriden balar
+        int dy = row < r ? r - row : (row > h - 1 - r ? row - (h - 1 - r) : 0);
+        int inset = r - static_cast<int>(sqrt(static_cast<double>(r) * r - static_cast<double>(dy) * dy) + 0.5);
+        Span(x + inset, x + w - 1 - inset, y + row, index);
+    }
+}
+
+// Orta nokta elips algoritmas; drt eyrek simetriyle izilir
+void IndexedCanvas::Ellipse(int cx, int cy, int rx, int ry, unsigned int color) {
+    if (rx < 0 || ry < 0) return;
+    int index = ColorIndex(color);
+    if (rx == 0 || ry == 0) {
+        Span(cx - rx, cx + rx, cy, index);
+        VSpan(cx, cy - ry, cy + ry, index);
+        return;
+    }
+    auto plot4 = [&](long long x, long long y) {
+        int px = static_cast<int>(x), py = static_cast<int>(y);
+        Put(cx + px, cy + py, index);
+        Put(cx - px, cy + py, index);
+        Put(cx + px, cy - py, index);
+        Put(cx - px, cy - py, index);
+    };
+    long long rx2 = static_cast<long long>(rx) * rx, ry2 = static_cast<long long>(ry) * ry;
+    long long x = 0, y = ry;
+    long long dx = 0, dy = 2 * rx2 * y;
+    // Blge 1: eimin mutlak deeri 1'den kk, her admda x artar
+    long long p = ry2 - rx2 * ry + rx2 / 4;
+    while (dx < dy) {
+        plot4(x, y);
+        x++;
+        dx += 2 * ry2;
+        if (p < 0) p += ry2 + dx;
+        else {
+            y--;
+            dy -= 2 * rx2;
+            p += ry2 + dx - dy;
+        }
+    }
+    // Blge 2: her admda y azalr
+    p = ry2 * (2 * x + 1) * (2 * x + 1) / 4 + rx2 * (y - 1) * (y - 1) - rx2 * ry2;
+    while (y >= 0) {
+        plot4(x, y);
+        y--;
+        dy -= 2 * rx2;
+        if (p > 0) p += rx2 - dy;
+        else {
+            x++;
+            dx += 2 * ry2;
+            p += rx2 - dy + dx;
+        }
+    }
+}
+
+void IndexedCanvas::FillEllipse(int cx, int cy, int rx, int ry, unsigned int color) {
+    if (rx < 0 || ry < 0) return;
+    int index = ColorIndex(color);
+    for (int dy = -ry; dy <= ry; dy++) {
+        double t = ry > 0 ? static_cast<double>(dy) / ry : 0.0;
+        int half = static_cast<int>(rx * sqrt(1.0 - t * t) + 0.5);
+        Span(cx - half, cx + half, cy + dy, index);
+    }
+}
+
+void IndexedCanvas::MarkPlus(int x, int y, int size, unsigned int color) {
+    int index = ColorIndex(color);
+    Span(x - size, x + size, y, index);
+    VSpan(x, y - size, y + size, index);
+}
+
+void IndexedCanvas::MarkVert(int x, int y, int size, unsigned int color) {
+    VSpan(x, y - size, y + size, ColorIndex(color));
+}
+
+void IndexedCanvas::MarkHorz(int x, int y, int size, unsigned int color) {
+    Span(x - size, x + size, y, ColorIndex(color));
+}
+
+void IndexedCanvas::Arc(int cx, int cy, int r, unsigned int color, int arc_strt, int arc_end) {
+    if (r <= 0) return;
+    int index = ColorIndex(color);
+    // Yay boyunca ardk noktalar aras bir pikseli gemeyecek adm
+    double step = 1.0 / r;
+    double a0 = arc_strt * M_PI / 180.0, a1 = arc_end * M_PI / 180.0;
+    for (double a = a0; a <= a1 + step * 0.5; a += step) {
+        double t = a > a1 ? a1 : a;
+        Put(cx + static_cast<int>(lround(r * cos(t))), cy + static_cast<int>(lround(r * sin(t))), index);
+    }
+}
+
+void IndexedCanvas::Text(int x, int y, const char* txt, unsigned int color) {
+    size_t len = txt ? strlen(txt) : 0;
+    if (len == 0) return;
+    int index = ColorIndex(color);
+
+    // Yaz tipi ktphanenin iinde; metin geici 32 bit resme baslp indekse evrilir
+    int tw = static_cast<int>(len) * 12 + 12, th = 24;
+    if (text_scratch.X() != tw || text_scratch.Y() != th) CreateImage(text_scratch, tw, th, ICB_UINT);
+    text_scratch = 0;
+    Impress12x20(text_scratch, 0, 0, txt, 0xFFFFFFFF);
+
+    for (int sy = 0; sy < th; sy++) {
+        const unsigned int* src = &text_scratch.U(1, sy + 1);
+        for (int sx = 0; sx < tw; sx++) {
+            if (src[sx]) Put(x + sx, y + sy, index);
+        }
+    }
+}
+
+//------------------------------------ GENLETME ------------------------------------
+
+// Paletin B, G, R, A bayt dzlemleri; pshufb ile 16 indeks tek komutta zlr
+struct PalettePlanes {
+    __m128i b, g, r, a;
+};
+
+static PalettePlanes SplitPalette(const unsigned int* palette, int n) {
+    alignas(16) unsigned char planes[4][16] = {};
+    for (int i = 0; i < n && i < 16; i++) {
+        planes[0][i] = static_cast<unsigned char>(palette[i]);
+        planes[1][i] = static_cast<unsigned char>(palette[i] >> 8);
+        planes[2][i] = static_cast<unsigned char>(palette[i] >> 16);
+        planes[3][i] = static_cast<unsigned char>(palette[i] >> 24);
+    }
+    PalettePlanes p;
+    p.b = _mm_load_si128(reinterpret_cast<const __m128i*>(planes[0]));
+    p.g = _mm_load_si128(reinterpret_cast<const __m128i*>(planes[1]));
+    p.r = _mm_load_si128(reinterpret_cast<const __m128i*>(planes[2]));
+    p.a = _mm_load_si128(reinterpret_cast<const __m128i*>(planes[3]));
+    return p;
+}
+
+// 16 indeks -> 16 BGRA piksel (4 vektr)
+static inline void Expand16(const PalettePlanes& p, __m128i idx, __m128i out[4]) {
+    __m128i b = _mm_shuffle_epi8(p.b, idx);
+    __m128i g = _mm_shuffle_epi8(p.g, idx);
+    __m128i r = _mm_shuffle_epi8(p.r, idx);
+    __m128i a = _mm_shuffle_epi8(p.a, idx);
+    __m128i bg_lo = _mm_unpacklo_epi8(b, g), bg_hi = _mm_unpackhi_epi8(b, g);
+    __m128i ra_lo = _mm_unpacklo_epi8(r, a), ra_hi = _mm_unpackhi_epi8(r, a);
+    out[0] = _mm_unpacklo_epi16(bg_lo, ra_lo);
+    out[1] = _mm_unpackhi_epi16(bg_lo, ra_lo);
+    out[2] = _mm_unpacklo_epi16(bg_hi, ra_hi);
+    out[3] = _mm_unpackhi_epi16(bg_hi, ra_hi);
+}
+
+// Satrdaki x..x+15 piksellerinin indeksleri
+static inline __m128i LoadIndices16(const unsigned char* row, int x, int bits) {
+    if (bits == CANVAS_8BIT) return _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x));
+    __m128i packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(row + (x >> 1)));
+    __m128i mask = _mm_set1_epi8(0x0F);
+    __m128i hi = _mm_and_si128(_mm_srli_epi16(packed, 4), mask); // ift pikseller st yarm baytta
+    __m128i lo = _mm_and_si128(packed, mask);
+    return _mm_unpacklo_epi8(hi, lo);
+}
+
+// Bir satr 32 bit piksellere evirir
+static void ExpandRow32(const unsigned char* row, int width, int bits, const unsigned int* palette,
+    const PalettePlanes* planes, unsigned int* dst) {
+
+    int x = 0;
+    if (planes) {
+        for (; x + 16 <= width; x += 16) {
+            __m128i px[4];
+            Expand16(*planes, LoadIndices16(row, x, bits), px);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), px[0]);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x + 4), px[1]);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x + 8), px[2]);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x + 12), px[3]);
+        }
+    }
+    if (bits == CANVAS_8BIT) {
+        for (; x < width; x++) dst[x] = palette[row[x]];
+    }
+    else {
+        for (; x < width; x++) dst[x] = palette[(x & 1) ? (row[x >> 1] & 0x0F) : (row[x >> 1] >> 4)];
+    }
+}
+
+bool IndexedCanvas::ToRGB32(ICBYTES& out) {
+    if (width <= 0) return false;
+    if (GetType(out) != ICB_UINT || out.X() != width || out.Y() != height) CreateImage(out, width, height, ICB_UINT);
+
+    PalettePlanes planes;
+    bool simd = palette_size <= 16 && HasSSSE3();
+    if (simd) planes = SplitPalette(palette, palette_size);
+
+    for (int y = 0; y < height; y++) {
+        ExpandRow32(Row(y), width, bits, palette, simd ? &planes : nullptr, &out.U(1, y + 1));
+    }
+    return true;
+}
+
+bool IndexedCanvas::ToRGB24(std::vector<unsigned char>& out) {
+    if (width <= 0) return false;
+    out.resize(static_cast<size_t>(width) * height * 3);
+
+    PalettePlanes planes;
+    bool simd = palette_size <= 16 && HasSSSE3();
+    if (simd) planes = SplitPalette(palette, palette_size);
+    // BGRA x4 -> BGR x4 (12 bayt)
+    const __m128i drop_alpha = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    std::vector<unsigned int> tail(16);
+
+    for (int y = 0; y < height; y++) {
+        const unsigned char* row = Row(y);
+        unsigned char* dst = out.data() + static_cast<size_t>(y) * width * 3;
+        int x = 0;
+        if (simd) {
+            for (; x + 16 <= width; x += 16) {
+                __m128i px[4];
+                Expand16(planes, LoadIndices16(row, x, bits), px);
+                // 16 baytlk yazmalar bir sonraki 12 baytla rtr; son para tamasn diye geici alana
+                unsigned char* d = dst + x * 3;
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(d), _mm_shuffle_epi8(px[0], drop_alpha));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(d + 12), _mm_shuffle_epi8(px[1], drop_alpha));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(d + 24), _mm_shuffle_epi8(px[2], drop_alpha));
+                alignas(16) unsigned char last[16];
+                _mm_store_si128(reinterpret_cast<__m128i*>(last), _mm_shuffle_epi8(px[3], drop_alpha));
+                memcpy(d + 36, last, 12);
+            }
+        }
+        if (x < width) {
+            int n = width - x;
+            if (static_cast<int>(tail.size()) < n) tail.resize(n);
+            ExpandRow32(row + (bits == CANVAS_8BIT ? x : x / 2), n, bits, palette, nullptr, tail.data());
+            for (int i = 0; i < n; i++) {
+                dst[(x + i) * 3 + 0] = static_cast<unsigned char>(tail[i]);
+                dst[(x + i) * 3 + 1] = static_cast<unsigned char>(tail[i] >> 8);
+                dst[(x + i) * 3 + 2] = static_cast<unsigned char>(tail[i] >> 16);
+            }
+        }
+    }
+    return true;
+}
+
+bool IndexedCanvas::EncodeBMP(std::vector<unsigned char>& out) const {
+    if (width <= 0) return false;
+    int colors = palette_size > 0 ? palette_size : 1;
+    long long pixel_bytes = static_cast<long long>(stride) * height;
+
+    unsigned char* p = BeginBMP(out, width, height, bits, colors, static_cast<size_t>(pixel_bytes));
+    for (int i = 0; i < colors; i++) {
+        unsigned int c = palette[i] & 0x00FFFFFF; // RGBQUAD: B, G, R, 0
+        memcpy(p, &c, 4);
+        p += 4;
+    }
+    // Satr uzunluu zaten 4'n kat ve 4 bitte ift piksel st yarm baytta: BMP dzeniyle ayn
+    memcpy(p, pixels.data(), static_cast<size_t>(pixel_bytes));
+    return true;
+}
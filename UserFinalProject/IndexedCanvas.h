@@ -0,0 +1,80 @@
+// IndexedCanvas.h
+// Renk paletli (4 veya 8 bit indeksli) tuval. Az renkli grafikler 32 bit ICB_UINT
+// yerine piksel bana yarm ya da bir bayt kullanr; ARGB/RGB24'e geniletme
+// yalnzca gsterim veya da aktarm annda yaplr (palet en fazla 16 renkse SSSE3 ile).
+//
+// Koordinatlar ktphanenin izim fonksiyonlarnda olduu gibi sol st (0,0)'dan balar.
+// izim metotlar ARGB renk alr ve renk paletinde karl olan indeksi yazar.
+//
+// ekiller ic_media.h'deki ayn adl fonksiyonlarla ayn parametreleri alr ama kendi tarama
+// dnmn kullanr; sonu ktphanenin 32 bit izimiyle piksel piksel ayn deildir.
+// Arc, TiltedEllipseArc'n yalnzca eimsiz ember halidir.
+#pragma once
+#include "icbytes.h"
+
+#include <vector>
+
+#define CANVAS_4BIT     4
+#define CANVAS_8BIT     8
+
+class IndexedCanvas
+{
+    int width = 0, height = 0;
+    int bits;
+    int stride = 0;                      // satr bana bayt, BMP ile uyumlu olmas iin 4'n kat
+    std::vector<unsigned char> pixels;
+    unsigned int palette[256];
+    int palette_size = 0;
+    ICBYTES text_scratch;                // Impress12x20 ktsn indekse evirmek iin
+
+    void Put(int x, int y, int index);
+    void FillSpan(int x0, int x1, int y, int index);
+    void Span(int x0, int x1, int y, int index);
+    void VSpan(int x, int y0, int y1, int index);
+public:
+    explicit IndexedCanvas(int bits_per_pixel = CANVAS_8BIT);
+    IndexedCanvas(const IndexedCanvas&) = delete;
+    IndexedCanvas& operator=(const IndexedCanvas&) = delete;
+
+    // Tuvali yaratr, paleti sfrlar ve arka plan rengiyle doldurur.
+    bool Create(int w, int h, unsigned int backcolor);
+
+    int Width() const { return width; }
+    int Height() const { return height; }
+    int Bits() const { return bits; }
+    int PaletteSize() const { return palette_size; }
+    const unsigned int* Palette() const { return palette; }
+    const unsigned char* Row(int y) const { return pixels.data() + static_cast<size_t>(y) * stride; }
+    size_t Bytes() const { return pixels.size(); }
+
+    // Rengin palet indeksi; palet doluysa en yakn renk dner.
+    int ColorIndex(unsigned int argb);
+    int GetIndex(int x, int y) const;
+
+    //________________ ZM ________________
+    void Clear(unsigned int color);
+    void FillRect(int x, int y, int w, int h, unsigned int color);
+    void Rect(int x, int y, int w, int h, unsigned int color);
+    void FillRoundRect(int x, int y, int w, int h, int r, unsigned int color);
+    void Line(int x1, int y1, int x2, int y2, unsigned int color);
+    // (cx, cy) merkezli; rx, ry yaraplar
+    void Ellipse(int cx, int cy, int rx, int ry, unsigned int color);
+    void FillEllipse(int cx, int cy, int rx, int ry, unsigned int color);
+    void Circle(int cx, int cy, int r, unsigned int color) { Ellipse(cx, cy, r, r, color); }
+    void FillCircle(int cx, int cy, int r, unsigned int color) { FillEllipse(cx, cy, r, r, color); }
+    // (x, y) merkezli, kollar size uzunluunda iaretler
+    void MarkPlus(int x, int y, int size, unsigned int color);
+    void MarkVert(int x, int y, int size, unsigned int color);
+    void MarkHorz(int x, int y, int size, unsigned int color);
+    // ember yay; alar derece, Y aa doru (CreatePieChart ile ayn yn)
+    void Arc(int cx, int cy, int r, unsigned int color, int arc_strt = 0, int arc_end = 360);
+    void Text(int x, int y, const char* txt, unsigned int color);
+
+    //________________ DIA AKTARIM ________________
+    // ICB_UINT resim retir (DisplayImage vb. iin)
+    bool ToRGB32(ICBYTES& out);
+    // Satrlar ardk BGR lleri olarak yazar, satr sonunda dolgu yoktur
+    bool ToRGB24(std::vector<unsigned char>& out);
+    // 4/8 bit paletli BMP dosyas; pikseller geniletilmeden yazlr
+    bool EncodeBMP(std::vector<unsigned char>& out) const;
+};
@@ -0,0 +1,512 @@
+// LineGraphDecimated.cpp
+#include "LineGraphDecimated.h"
+#include "Raster.h"
+
+#include <emmintrin.h>  // SSE2 min/max
+#include <thread>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+
+// rnek i'nin dt stun ve stun c'nin ilk rnei. Her ikisi de ayn tamsay
+// blmesinden tredii iin ColumnOf(ColumnStart(c)) == c her zaman salanr.
+static inline int ColumnOf(long long i, long long n, int width) {
+    return static_cast<int>(i * width / n);
+}
+
+static inline long long ColumnStart(int c, long long n, int width) {
+    return (c * n + width - 1) / width;
+}
+
+//________________ MIN/MAX ________________
+
+// Sonlu olmayan rnekler (NaN, sonsuz) tm izimlerde yok saylr: izgi nceki sonlu
+// rnekten sonrakine ekilir. Seyreltilmi ve tam znrlkl izim bu yzden ayn kalr.
+template<class T>
+static inline bool Finite(T v) { return std::isfinite(static_cast<double>(v)); }
+
+// MinMax sonlu rnek yoksa false dner; mn = +sonsuz, mx = -sonsuz kalr, bylece sonu
+// min/max birletirmelerinde etkisizdir.
+static bool MinMax(const double* p, long long n, double& mn, double& mx) {
+    const double inf = std::numeric_limits<double>::infinity();
+    long long i = 0;
+    double lo = inf, hi = -inf;
+    if (n >= 8) {
+        const __m128d pinf = _mm_set1_pd(inf), ninf = _mm_set1_pd(-inf), zero = _mm_setzero_pd();
+        __m128d lo0 = pinf, lo1 = pinf, hi0 = ninf, hi1 = ninf;
+        for (; i + 4 <= n; i += 4) {
+            __m128d a = _mm_loadu_pd(p + i), b = _mm_loadu_pd(p + i + 2);
+            // x - x yalnzca sonlu x iin 0'dr; dierleri min iin +sonsuz, max iin -sonsuz olur
+            __m128d fa = _mm_cmpeq_pd(_mm_sub_pd(a, a), zero), fb = _mm_cmpeq_pd(_mm_sub_pd(b, b), zero);
+            lo0 = _mm_min_pd(lo0, _mm_or_pd(_mm_and_pd(fa, a), _mm_andnot_pd(fa, pinf)));
+            lo1 = _mm_min_pd(lo1, _mm_or_pd(_mm_and_pd(fb, b), _mm_andnot_pd(fb, pinf)));
+            hi0 = _mm_max_pd(hi0, _mm_or_pd(_mm_and_pd(fa, a), _mm_andnot_pd(fa, ninf)));
+            hi1 = _mm_max_pd(hi1, _mm_or_pd(_mm_and_pd(fb, b), _mm_andnot_pd(fb, ninf)));
+        }
+        lo0 = _mm_min_pd(lo0, lo1);
+        hi0 = _mm_max_pd(hi0, hi1);
+        lo = _mm_cvtsd_f64(_mm_min_sd(lo0, _mm_unpackhi_pd(lo0, lo0)));
+        hi = _mm_cvtsd_f64(_mm_max_sd(hi0, _mm_unpackhi_pd(hi0, hi0)));
+    }
+    for (; i < n; i++) {
+        if (!Finite(p[i])) continue;
+        if (p[i] < lo) lo = p[i];
+        if (p[i] > hi) hi = p[i];
+    }
+    mn = lo;
+    mx = hi;
+    return lo <= hi;
+}
+
+static bool MinMax(const float* p, long long n, double& mn, double& mx) {
+    const float inf = std::numeric_limits<float>::infinity();
+    long long i = 0;
+    float lo = inf, hi = -inf;
+    if (n >= 16) {
+        const __m128 pinf = _mm_set1_ps(inf), ninf = _mm_set1_ps(-inf), zero = _mm_setzero_ps();
+        __m128 lo0 = pinf, lo1 = pinf, hi0 = ninf, hi1 = ninf;
+        for (; i + 8 <= n; i += 8) {
+            __m128 a = _mm_loadu_ps(p + i), b = _mm_loadu_ps(p + i + 4);
+            __m128 fa = _mm_cmpeq_ps(_mm_sub_ps(a, a), zero), fb = _mm_cmpeq_ps(_mm_sub_ps(b, b), zero);
+            lo0 = _mm_min_ps(lo0, _mm_or_ps(_mm_and_ps(fa, a), _mm_andnot_ps(fa, pinf)));
+            lo1 = _mm_min_ps(lo1, _mm_or_ps(_mm_and_ps(fb, b), _mm_andnot_ps(fb, pinf)));
+            hi0 = _mm_max_ps(hi0, _mm_or_ps(_mm_and_ps(fa, a), _mm_andnot_ps(fa, ninf)));
+            hi1 = _mm_max_ps(hi1, _mm_or_ps(_mm_and_ps(fb, b), _mm_andnot_ps(fb, ninf)));
+        }
+        lo0 = _mm_min_ps(lo0, lo1);
+        hi0 = _mm_max_ps(hi0, hi1);
+        lo0 = _mm_min_ps(lo0, _mm_movehl_ps(lo0, lo0));
+        hi0 = _mm_max_ps(hi0, _mm_movehl_ps(hi0, hi0));
+        lo = _mm_cvtss_f32(_mm_min_ss(lo0, _mm_shuffle_ps(lo0, lo0, 1)));
+        hi = _mm_cvtss_f32(_mm_max_ss(hi0, _mm_shuffle_ps(hi0, hi0, 1)));
+    }
+    for (; i < n; i++) {
+        if (!Finite(p[i])) continue;
+        if (p[i] < lo) lo = p[i];
+        if (p[i] > hi) hi = p[i];
+    }
+    mn = lo;
+    mx = hi;
+    return lo <= hi;
+}
+
+// Tamsay tipleri her zaman sonludur: derleyici vektrletirmesine braklr
+template<class T>
+static bool MinMax(const T* p, long long n, double& mn, double& mx) {
+    T lo = p[0], hi = p[0];
+    for (long long i = 1; i < n; i++) {
+        lo = p[i] < lo ? p[i] : lo;
+        hi = p[i] > hi ? p[i] : hi;
+    }
+    mn = static_cast<double>(lo);
+    mx = static_cast<double>(hi);
+    return true;
+}
+
+// [a, b) iindeki ilk ve son sonlu rnek; stunda sonlu rnek olduu bilindiinde arlr
+template<class T>
+static void FirstLast(const T* p, long long a, long long b, double& first, double& last) {
+    while (!Finite(p[a])) a++;
+    while (!Finite(p[b - 1])) b--;
+    first = static_cast<double>(p[a]);
+    last = static_cast<double>(p[b - 1]);
+}
+
+// Girdinin tipine gre f(const T* p, long long n) arr
+template<class F>
+static bool WithSamples(ICBYTES& in, F&& f) {
+    long long n = in.X();
+    if (n <= 0) return false;
+    switch (GetType(in)) {
+    case ICB_DOUBLE: f(&in.D(1), n); return true;
+    case ICB_FLOAT:  f(&in.F(1), n); return true;
+    case ICB_INT:    f(&in.I(1), n); return true;
+    case ICB_SHORT:  f(&in.S(1), n); return true;
+    case ICB_UCHAR:  f(&in.B(1), n); return true;
+    }
+    return false;
+}
+
+// [0, count) araln i paracklarna bler; kk iler tek i paracnda kalr.
+template<class F>
+static void ParallelFor(int count, long long work, F&& f) {
+    long long threads = std::thread::hardware_concurrency();
+    threads = std::min(threads, static_cast<long long>(count));
+    threads = std::min(threads, work / 65536 + 1);
+    if (threads <= 1) {
+        f(0, count);
+        return;
+    }
+    std::vector<std::thread> pool;
+    for (long long k = 0; k < threads; k++) {
+        int b = static_cast<int>(count * k / threads), e = static_cast<int>(count * (k + 1) / threads);
+        pool.emplace_back([&f, b, e] { f(b, e); });
+    }
+    for (auto& t : pool) t.join();
+}
+
+template<class T>
+static void ColumnPass(const T* p, long long n, int width, std::vector<ColumnStats>& cols) {
+    cols.resize(width);
+    ParallelFor(width, n, [&](int c0, int c1) {
+        for (int c = c0; c < c1; c++) {
+            ColumnStats& cs = cols[c];
+            long long a = ColumnStart(c, n, width), b = ColumnStart(c + 1, n, width);
+            // Yalnzca sonlu olmayan rnek ieren stun bo saylr
+            cs.empty = a >= b || !MinMax(p + a, b - a, cs.min, cs.max);
+            if (cs.empty) continue;
+            FirstLast(p, a, b, cs.first, cs.last);
+        }
+    });
+}
+
+//________________ ZM ________________
+
+// Deerden satra monoton (artmayan) dnm; stun min/max' bu yzden stundaki
+// tm rneklerin kaplad satr aralnn ularn verir. Yalnzca sonlu deerlerle
+// arlr; ara sonu yine de int'e evrilmeden nce resim yksekliine sktrlr.
+struct YScale {
+    double vmin, scale;
+    int height;
+    int operator()(double v) const {
+        double r = std::floor((v - vmin) * scale + 0.5);
+        if (!(r > 0)) return height - 1;
+        if (r >= height - 1) return 0;
+        return (height - 1) - static_cast<int>(r);
+    }
+};
+
+static YScale MakeScale(double vmin, double vmax, int height) {
+    YScale s;
+    s.vmin = vmin;
+    s.scale = 0.0;
+    if (vmax > vmin) {
+        // vmax - vmin sonlu iki deer iin de taabilir (r. -1e308, 1e308)
+        double range = vmax - vmin;
+        s.scale = std::isfinite(range) ? (height - 1) / range : (height - 1) / (vmax * 0.5 - vmin * 0.5) * 0.5;
+    }
+    s.height = height;
+    return s;
+}
+
+// Resim satrlar; ICB_UINT resmin satrlar bellekte ardktr
+struct PixelRows {
+    std::vector<unsigned int*> rows;
+    unsigned int color;
+
+    PixelRows(ICBYTES& img, int height, unsigned int c) : rows(height), color(c) {
+        for (int y = 0; y < height; y++) rows[y] = &img.U(1, y + 1);
+    }
+    void Put(int x, int y) { rows[y][x] = color; }
+    void VSpan(int x, int y0, int y1) {
+        if (y0 > y1) std::swap(y0, y1);
+        for (int y = y0; y <= y1; y++) rows[y][x] = color;
+    }
+    // Ular resim iinde olduundan krpma gerekmez
+    void Line(int x1, int y1, int x2, int y2) {
+        RasterLine(x1, y1, x2, y2, [this](int x, int y) { rows[y][x] = color; });
+    }
+};
+
+static bool CreatePlot(ICBYTES& img, int width, int height, int background) {
+    if (width <= 0 || height <= 0) return false;
+    CreateImage(img, width, height, ICB_UINT);
+    img = background;
+    return true;
+}
+
+// IndexedCanvas'a ayn stun izimini yapan hedef
+struct CanvasRows {
+    IndexedCanvas& canvas;
+    unsigned int color;
+
+    void VSpan(int x, int y0, int y1) { canvas.Line(x, y0, x, y1, color); }
+    void Line(int x1, int y1, int x2, int y2) { canvas.Line(x1, y1, x2, y2, color); }
+};
+
+// Stun zetlerini izer: stun iinde [min, max] dikey aral, dolu iki stun
+// arasnda ncekinin son deerinden sonrakinin ilk deerine izgi. Bunlar tam
+// znrlkl izimde srasyla ayn stundaki ardk rnekleri birletiren dikey
+// izgilerin birleimi ve iki stunu birletiren tek izgidir.
+template<class Target>
+static int DrawColumns(Target& px, const std::vector<ColumnStats>& cols, int width, int height) {
+    double vmin = std::numeric_limits<double>::max(), vmax = -std::numeric_limits<double>::max();
+    for (const ColumnStats& cs : cols) {
+        if (cs.empty) continue;
+        vmin = std::min(vmin, cs.min);
+        vmax = std::max(vmax, cs.max);
+    }
+    YScale ys = MakeScale(vmin, vmax, height);
+    int drawn = 0, prev = -1;
+    for (int c = 0; c < width; c++) {
+        const ColumnStats& cs = cols[c];
+        if (cs.empty) continue;
+        px.VSpan(c, ys(cs.max), ys(cs.min));
+        if (prev >= 0) px.Line(prev, ys(cols[prev].last), c, ys(cs.first));
+        prev = c;
+        drawn++;
+    }
+    return drawn;
+}
+
+static int DrawColumns(ICBYTES& img, const std::vector<ColumnStats>& cols, int width, int height, int color, int background) {
+    if (!CreatePlot(img, width, height, background)) return 0;
+    PixelRows px(img, height, color);
+    return DrawColumns(px, cols, width, height);
+}
+
+int DecimatedLineGraph(ICBYTES& in, ICBYTES& img, int width, int height, int color, int background) {
+    if (width <= 0 || height <= 0) return 0;
+    std::vector<ColumnStats> cols;
+    bool ok = WithSamples(in, [&](auto p, long long n) { ColumnPass(p, n, width, cols); });
+    if (!ok) return 0;
+    return DrawColumns(img, cols, width, height, color, background);
+}
+
+int DecimatedLineGraph(ICBYTES& in, IndexedCanvas& canvas, unsigned int color) {
+    int width = canvas.Width(), height = canvas.Height();
+    if (width <= 0 || height <= 0) return 0;
+    std::vector<ColumnStats> cols;
+    bool ok = WithSamples(in, [&](auto p, long long n) { ColumnPass(p, n, width, cols); });
+    if (!ok) return 0;
+    CanvasRows px = { canvas, color };
+    return DrawColumns(px, cols, width, height);
+}
+
+int PlotFullResolution(ICBYTES& in, ICBYTES& img, int width, int height, int color, int background) {
+    int drawn = 0;
+    bool ok = WithSamples(in, [&](auto p, long long n) {
+        if (!CreatePlot(img, width, height, background)) return;
+        double vmin, vmax;
+        if (!MinMax(p, n, vmin, vmax)) return;
+        YScale ys = MakeScale(vmin, vmax, height);
+        PixelRows px(img, height, color);
+        int x = -1, y = 0;
+        for (long long i = 0; i < n; i++) {
+            if (!Finite(p[i])) continue;
+            int x2 = ColumnOf(i, n, width), y2 = ys(static_cast<double>(p[i]));
+            if (x < 0) px.Put(x2, y2);
+            else px.Line(x, y, x2, y2);
+            x = x2;
+            y = y2;
+        }
+        drawn = width;
+    });
+    return ok ? drawn : 0;
+}
+
+//________________ LTTB ________________
+
+// Sonlu olmayan rnekler seilmez ve ortalamaya katlmaz; sonlu rnek yoksa out bo kalr.
+template<class T>
+static void Lttb(const T* p, long long n, long long threshold, std::vector<long long>& out) {
+    out.clear();
+    if (threshold >= n || threshold < 3) {
+        for (long long i = 0; i < n; i++)
+            if (Finite(p[i])) out.push_back(i);
+        return;
+    }
+    long long head = 0, tail = n - 1;
+    while (head < n && !Finite(p[head])) head++;
+    if (head == n) return;
+    while (!Finite(p[tail])) tail--;
+    out.reserve(threshold);
+    double every = static_cast<double>(n - 2) / (threshold - 2);
+    long long a = head;
+    out.push_back(head);
+    for (long long k = 0; k < threshold - 2; k++) {
+        // Sonraki kovann ortalamas
+        long long nb = static_cast<long long>((k + 1) * every) + 1;
+        long long ne = std::min(static_cast<long long>((k + 2) * every) + 1, n);
+        double ax = static_cast<double>(a), ay = static_cast<double>(p[a]);
+        double avg_x = 0, avg_y = 0;
+        long long finite = 0;
+        for (long long i = nb; i < ne; i++) {
+            if (!Finite(p[i])) continue;
+            avg_x += static_cast<double>(i);
+            avg_y += static_cast<double>(p[i]);
+            finite++;
+        }
+        if (finite > 0) {
+            avg_x /= finite;
+            avg_y /= finite;
+        }
+        else {
+            avg_x = 0.5 * (nb + ne - 1);
+            avg_y = ay;
+        }
+
+        // Bu kovada a ve ortalama ile en byk geni yapan nokta; kova tamamen sonlu
+        // deilse bu kovadan nokta alnmaz
+        long long rb = static_cast<long long>(k * every) + 1, re = nb;
+        double best = -1;
+        long long pick = -1;
+        for (long long i = rb; i < re; i++) {
+            if (i <= a || !Finite(p[i])) continue;
+            double area = std::fabs((ax - avg_x) * (static_cast<double>(p[i]) - ay) - (ax - i) * (avg_y - ay));
+            if (area > best) { best = area; pick = i; }
+        }
+        if (pick < 0) continue;
+        out.push_back(pick);
+        a = pick;
+    }
+    if (tail > a) out.push_back(tail);
+}
+
+int SmoothLineGraph(ICBYTES& in, ICBYTES& img, int width, int height, int color, int background, int threshold) {
+    int drawn = 0;
+    if (threshold <= 0) threshold = 2 * width;
+    bool ok = WithSamples(in, [&](auto p, long long n) {
+        if (!CreatePlot(img, width, height, background)) return;
+        std::vector<long long> idx;
+        Lttb(p, n, threshold, idx);
+        double vmin, vmax;
+        if (idx.empty() || !MinMax(p, n, vmin, vmax)) return;
+        YScale ys = MakeScale(vmin, vmax, height);
+        PixelRows px(img, height, color);
+        int x = ColumnOf(idx[0], n, width), y = ys(static_cast<double>(p[idx[0]]));
+        px.Put(x, y);
+        for (size_t k = 1; k < idx.size(); k++) {
+            int x2 = ColumnOf(idx[k], n, width), y2 = ys(static_cast<double>(p[idx[k]]));
+            px.Line(x, y, x2, y2);
+            x = x2;
+            y = y2;
+        }
+        drawn = static_cast<int>(idx.size());
+    });
+    return ok ? drawn : 0;
+}
+
+//________________ PRAMT ________________
+
+bool LinePyramid::Build(ICBYTES& in) {
+    data = nullptr;
+    owned.clear();
+    levels.clear();
+    n = 0;
+    bool ok = WithSamples(in, [&](auto p, long long count) {
+        typedef typename std::remove_const<typename std::remove_pointer<decltype(p)>::type>::type T;
+        if (std::is_same<T, double>::value) {
+            data = reinterpret_cast<const double*>(p);
+        }
+        else {
+            owned.resize(count);
+            for (long long i = 0; i < count; i++) owned[i] = static_cast<double>(p[i]);
+            data = owned.data();
+        }
+        n = count;
+    });
+    if (!ok) return false;
+
+    // Seviye 0: bloklar paralel, SIMD ile. Sonlu rnei olmayan blok (+sonsuz, -sonsuz) tutar
+    // ve birletirmelerde etkisizdir.
+    long long blocks = (n + LINEPYRAMID_BLOCK - 1) / LINEPYRAMID_BLOCK;
+    levels.emplace_back(2 * blocks);
+    std::vector<double>& l0 = levels[0];
+    const double* d = data;
+    long long total = n;
+    ParallelFor(static_cast<int>(blocks), n, [&](int b0, int b1) {
+        for (long long b = b0; b < b1; b++) {
+            long long a = b * LINEPYRAMID_BLOCK, e = std::min(a + LINEPYRAMID_BLOCK, total);
+            MinMax(d + a, e - a, l0[2 * b], l0[2 * b + 1]);
+        }
+    });
+
+    // st seviyeler: ikier birletirme; tek kalan blok aynen tanr
+    while (levels.back().size() > 2) {
+        const std::vector<double>& lo = levels.back();
+        long long count = static_cast<long long>(lo.size() / 2);
+        std::vector<double> up(2 * ((count + 1) / 2));
+        for (long long i = 0; i < count; i += 2) {
+            double mn = lo[2 * i], mx = lo[2 * i + 1];
+            if (i + 1 < count) {
+                mn = std::min(mn, lo[2 * i + 2]);
+                mx = std::max(mx, lo[2 * i + 3]);
+            }
+            up[i] = mn;
+            up[i + 1] = mx;
+        }
+        levels.push_back(std::move(up));
+    }
+    return true;
+}
+
+void LinePyramid::RangeMinMax(long long a, long long b, double& mn, double& mx) const {
+    mn = std::numeric_limits<double>::infinity();
+    mx = -std::numeric_limits<double>::infinity();
+    if (a >= b) return;
+    double lo, hi;
+    long long fa = (a + LINEPYRAMID_BLOCK - 1) / LINEPYRAMID_BLOCK, fb = b / LINEPYRAMID_BLOCK;
+    if (fa >= fb) {
+        MinMax(data + a, b - a, mn, mx);
+        return;
+    }
+    // Tam bloklara girmeyen ba ve son ham rnekler
+    if (a < fa * LINEPYRAMID_BLOCK) {
+        MinMax(data + a, fa * LINEPYRAMID_BLOCK - a, lo, hi);
+        mn = std::min(mn, lo);
+        mx = std::max(mx, hi);
+    }
+    if (fb * LINEPYRAMID_BLOCK < b) {
+        MinMax(data + fb * LINEPYRAMID_BLOCK, b - fb * LINEPYRAMID_BLOCK, lo, hi);
+        mn = std::min(mn, lo);
+        mx = std::max(mx, hi);
+    }
+    // [fa, fb) bloklar: her seviyede yalnzca kenardaki tek bloklar alnr
+    for (size_t lv = 0; fa < fb && lv < levels.size(); lv++, fa >>= 1, fb >>= 1) {
+        const std::vector<double>& l = levels[lv];
+        if (fa & 1) {
+            mn = std::min(mn, l[2 * fa]);
+            mx = std::max(mx, l[2 * fa + 1]);
+            fa++;
+        }
+        if (fb & 1) {
+            fb--;
+            mn = std::min(mn, l[2 * fb]);
+            mx = std::max(mx, l[2 * fb + 1]);
+        }
+    }
+}
+
+void LinePyramid::RangeColumn(long long a, long long b, ColumnStats& cs) const {
+    cs.empty = a >= b;
+    if (cs.empty) return;
+    RangeMinMax(a, b, cs.min, cs.max);
+    // Yalnzca sonlu olmayan rnek ieren stun bo saylr (ColumnPass ile ayn)
+    cs.empty = !(cs.min <= cs.max);
+    if (cs.empty) return;
+    FirstLast(data, a, b, cs.first, cs.last);
+}
+
+int LinePyramid::Render(ICBYTES& img, long long first, long long count, int width, int height, int color, int background) const {
+    if (width <= 0 || height <= 0 || first < 0 || count <= 0 || first + count > n) return 0;
+    std::vector<ColumnStats> cols(width);
+    ParallelFor(width, count / LINEPYRAMID_BLOCK, [&](int c0, int c1) {
+        for (int c = c0; c < c1; c++)
+            RangeColumn(first + ColumnStart(c, count, width), first + ColumnStart(c + 1, count, width), cols[c]);
+    });
+    return DrawColumns(img, cols, width, height, color, background);
+}
+
+//________________ KARILATIRMA ________________
+
+static long long CountDiff(ICBYTES& a, ICBYTES& b, int width, int height) {
+    long long diff = 0;
+    for (int y = 1; y <= height; y++)
+        for (int x = 1; x <= width; x++)
+            if (a.U(x, y) != b.U(x, y)) diff++;
+    return diff;
+}
+
+long long CompareLineGraphs(ICBYTES& in, int width, int height) {
+    if (width <= 0 || height <= 0) return -1;
+    LinePyramid pyramid;
+    if (!pyramid.Build(in)) return -1;
+    // Sonlu rnei olmayan seride de  resim oluturulur ve bo kalr
+    ICBYTES full, dec, pyr;
+    PlotFullResolution(in, full, width, height, 0xffffff);
+    DecimatedLineGraph(in, dec, width, height, 0xffffff);
+    pyramid.Render(pyr, 0, pyramid.Size(), width, height, 0xffffff);
+    return CountDiff(full, dec, width, height) + CountDiff(full, pyr, width, height);
+}
@@ -0,0 +1,61 @@
+// LineGraphDecimated.h
+// Milyonlarca rnekli seriler iin stun bana min/max seyreltmeli izgi grafik.
+// Her piksel stunu iin min, max, ilk ve son deer bulunur; stun iinde dikey
+// bir aralk, stunlar arasnda ilk/son deerleri birletiren izgi izilir.
+// Sonu, ayn lekte tm ardk rnek iftlerini izen PlotFullResolution ile
+// piksel piksel ayndr, ancak rnek bana izim yerine stun bana izim yapar.
+//
+// Girdi 1 boyutlu (X uzunluklu) ICB_DOUBLE, ICB_FLOAT, ICB_INT, ICB_SHORT veya ICB_UCHAR matristir.
+// Sonlu olmayan rnekler (NaN, sonsuz) yok saylr: izgi nceki sonlu rnekten sonrakine
+// ekilir, yalnzca bu tr rnek ieren stunlar bo kalr.
+#pragma once
+#include "icbytes.h"
+#include "IndexedCanvas.h"
+
+#include <vector>
+
+// Stunun deer zeti
+struct ColumnStats {
+    double min, max, first, last;
+    bool empty;
+};
+
+// in'in tamamn width x height ICB_UINT resme izer. Dn: izilen stun says, hata ise 0.
+int DecimatedLineGraph(ICBYTES& in, ICBYTES& img, int width, int height, int color, int background = 0);
+// Ayn izimi Create ile hazrlanm paletli tuvalin tamamna, arka plan silmeden yapar.
+int DecimatedLineGraph(ICBYTES& in, IndexedCanvas& canvas, unsigned int color);
+
+// Karlatrma iin: her rnek iftini ayr izgiyle izen yava srm.
+int PlotFullResolution(ICBYTES& in, ICBYTES& img, int width, int height, int color, int background = 0);
+
+// in'i PlotFullResolution, DecimatedLineGraph ve LinePyramid::Render ile izip farkl piksel
+// saysn dner (beklenen 0); hata ise -1. rnein NaN ieren serilerle dorulama iin.
+long long CompareLineGraphs(ICBYTES& in, int width, int height);
+
+// Largest-Triangle-Three-Buckets ile threshold noktaya indirger ve noktalar izgiyle birletirir.
+// Grnm daha yumuaktr ama tepe noktalar kaybolabilir; birebir kt gerekiyorsa kullanmayn.
+int SmoothLineGraph(ICBYTES& in, ICBYTES& img, int width, int height, int color, int background = 0, int threshold = 0);
+
+// Yaknlatrma/kaydrma iin ok znrlkl min/max piramidi.
+// Seviye 0 LINEPYRAMID_BLOCK rneklik bloklarn min/max'n, her st seviye iki alt blou tutar.
+// Herhangi bir [a, b) aralnn min/max' O(log n) blok ve en fazla 2 blok ham rnekle bulunur.
+#define LINEPYRAMID_BLOCK 64
+
+class LinePyramid
+{
+    const double* data = nullptr;        // ICB_DOUBLE girdide dorudan girdi tamponu
+    std::vector<double> owned;           // dier tiplerde double kopya
+    long long n = 0;
+    std::vector<std::vector<double>> levels;   // her seviyede (min, max) iftleri art arda
+
+    void RangeColumn(long long a, long long b, ColumnStats& cs) const;
+public:
+    // ICB_DOUBLE girdi kopyalanmaz: piramit kullanld srece in deimemeli ve yaamal.
+    bool Build(ICBYTES& in);
+    long long Size() const { return n; }
+    // Sonlu rnek yoksa mn = +sonsuz, mx = -sonsuz
+    void RangeMinMax(long long a, long long b, double& mn, double& mx) const;
+
+    // [first, first+count) araln izer; DecimatedLineGraph'n o aralk iin retecei resimle ayndr.
+    int Render(ICBYTES& img, long long first, long long count, int width, int height, int color, int background = 0) const;
+};
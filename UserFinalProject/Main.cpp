@@ -2,106 +2,15 @@
 #include "icbytes.h"
 #include "ic_media.h"
 #include "icb_gui.h"
+#include "PieChart.h"
 
 #include <vector>
 #include <string>
-#include <numeric>   // std::accumulate iin
-#include <cmath>       // M_PI, cos, sin iin (geri M_PI Windows'ta dorudan tanml olmayabilir)
-#include <cstdio>      // sprintf_s iin
-#include <iostream>
-
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
 
 // Global GUI deikenleri
 int FRM_PieChart_Display;
 ICBYTES pie_chart_image_global;
 
-// Yardmc yap, her dilim iin bilgi tutar
-struct PieSliceInfo {
-    std::string label;
-    double value;
-    double percentage;
-    double start_angle_deg;
-    double end_angle_deg;
-    unsigned int color;
-};
-
-// Pasta Grafik Fonksiyonu
-void CreatePieChart(ICBYTES& img, const std::vector<PieSliceInfo>& slices,
-    const char* chart_title, int image_width, int image_height,
-    int center_x, int center_y, int radius,
-    unsigned int backcolor = 0xFFFFFFFF, unsigned int textcolor = 0xFF000000) {
-
-    // Marjlar ve dier sabitler
-    int top_margin_for_title = 30;      // Balk iin st boluk
-    int legend_label_offset_x = 25;   // Lejantta renk kutucuu ile metin aras boluk
-    int legend_color_box_size = 15;   // Lejanttaki renk kutucuunun boyutu
-    int legend_item_spacing_y = 25;   // Lejanttaki satrlar aras dikey boluk
-    int legend_initial_x_offset = 30; // Pastann sandan lejantn ne kadar uzakta balayaca
-    int legend_initial_y_offset = 20; // Baln altndan lejantn ne kadar aada balayaca
-
-
-    CreateImage(img, image_width, image_height, ICB_UINT);
-    img = backcolor;
-
-    // Balk
-    if (chart_title && strlen(chart_title) > 0) {
-        int title_len_px = strlen(chart_title) * 12; // Yaklak piksel uzunluu (12px/char varsaym)
-        int title_x_pos = (image_width - title_len_px) / 2; // Resmi ortala
-        if (title_x_pos < 5) title_x_pos = 5; // Kenara ok yapmasn
-        // Impress12x20 font ykseklii ~20px. Marjn ortasna yerletirmek iin:
-        Impress12x20(img, title_x_pos, (top_margin_for_title - 20) / 2, chart_title, textcolor);
-    }
-
-    if (slices.empty()) {
-        Impress12x20(img, 10, top_margin_for_title + 10, "Pasta grafik icin veri yok.", textcolor);
-        return;
-    }
-
-    // Dilimleri iz
-    for (const auto& slice : slices) {
-        TiltedEllipseArc(img, center_x, center_y, radius, radius, 0,
-            slice.color, static_cast<int>(slice.start_angle_deg), static_cast<int>(slice.end_angle_deg));
-
-        double start_rad = slice.start_angle_deg * M_PI / 180.0;
-        double end_rad = slice.end_angle_deg * M_PI / 180.0;
-
-        // Yayn balang ve biti noktalarn hesapla (Y ekseni aa doru artar)
-        // GDI+'da veya benzeri sistemlerde Y genellikle yukar doru artar, bu yzden sins negatif olur.
-        // Ancak I-See-Bytes'n Line fonksiyonunun nasl altna bal.
-        // Ekran koordinatlar (sol st 0,0, Y aa) iin sins pozitif kalmal.
-        int x_start_on_arc = center_x + static_cast<int>(radius * cos(start_rad));
-        int y_start_on_arc = center_y + static_cast<int>(radius * sin(start_rad));
-
-        int x_end_on_arc = center_x + static_cast<int>(radius * cos(end_rad));
-        int y_end_on_arc = center_y + static_cast<int>(radius * sin(end_rad));
-
-        Line(img, center_x, center_y, x_start_on_arc, y_start_on_arc, slice.color);
-        Line(img, center_x, center_y, x_end_on_arc, y_end_on_arc, slice.color);
-    }
-
-    // Lejant / Etiketler
-    int legend_x_start = center_x + radius + legend_initial_x_offset;
-    int legend_y_start = top_margin_for_title + legend_initial_y_offset;
-
-    for (size_t i = 0; i < slices.size(); ++i) {
-        const auto& slice = slices[i];
-        // Lejantn Y pozisyonu, metnin dikeyde ortalanmas iin metin yksekliinin yars (~10px) dlerek
-        int current_y_for_text = legend_y_start + i * legend_item_spacing_y;
-        int current_y_for_box = current_y_for_text; // Kutu ve metin ayn hizada balasn
-
-        if (current_y_for_box + legend_color_box_size > image_height - 5) break; // Lejant resim dna tayorsa izme
-
-        FillRect(img, legend_x_start, current_y_for_box, legend_color_box_size, legend_color_box_size, slice.color);
-
-        char legend_text[100];
-        sprintf_s(legend_text, sizeof(legend_text), "%s (%.1f%%)", slice.label.c_str(), slice.percentage);
-        Impress12x20(img, legend_x_start + legend_color_box_size + 5, current_y_for_text, legend_text, textcolor); // Renk kutusundan 5px saa
-    }
-}
-
 
 // --- GUI Uygulamas ---
 void GenerateAndDisplayPieChart_Main_GUI() {
@@ -114,33 +23,7 @@ void GenerateAndDisplayPieChart_Main_GUI() {
         {"Diger", 10.0}
     };
 
-    double total_value = 0;
-    for (const auto& item : raw_data) {
-        total_value += item.second;
-    }
-
-    std::vector<PieSliceInfo> slices_info;
-    if (total_value > 1e-9) { // Sfra blme hatasn engelle
-        double current_angle_deg = 0;
-        // Renk paleti (daha fazla dilim iin geniletilebilir)
-        std::vector<unsigned int> colors = {
-            0xFFE91E63, 0xFF9C27B0, 0xFF2196F3, 0xFF4CAF50, 0xFFFFC107, 0xFFFF5722
-        };
-        int color_index = 0;
-
-        for (const auto& item : raw_data) {
-            PieSliceInfo slice;
-            slice.label = item.first;
-            slice.value = item.second;
-            slice.percentage = (item.second / total_value) * 100.0;
-            slice.start_angle_deg = current_angle_deg;
-            slice.end_angle_deg = current_angle_deg + (slice.percentage / 100.0) * 360.0;
-            slice.color = colors[color_index % colors.size()];
-            color_index++;
-            slices_info.push_back(slice);
-            current_angle_deg = slice.end_angle_deg;
-        }
-    }
+    std::vector<PieSliceInfo> slices_info = BuildPieSlices(raw_data);
 
 
     // Grafik parametreleri
@@ -0,0 +1,183 @@
+// PieChart.cpp
+#include "PieChart.h"
+#include "Raster.h"
+#include "ic_media.h"
+
+#include <cmath>       // M_PI, cos, sin iin (geri M_PI Windows'ta dorudan tanml olmayabilir)
+#include <cstdio>      // sprintf_s iin
+#include <cstring>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+const std::vector<unsigned int>& DefaultPieColors() {
+    static const std::vector<unsigned int> colors = {
+        0xFFE91E63, 0xFF9C27B0, 0xFF2196F3, 0xFF4CAF50, 0xFFFFC107, 0xFFFF5722
+    };
+    return colors;
+}
+
+std::vector<PieSliceInfo> BuildPieSlices(const std::vector<std::pair<std::string, double>>& raw_data,
+    const std::vector<unsigned int>& colors) {
+
+    double total_value = 0;
+    for (const auto& item : raw_data) {
+        total_value += item.second;
+    }
+
+    std::vector<PieSliceInfo> slices_info;
+    // Sfra blme ve tama (toplam sonsuz olursa alar NaN olur) engellenir
+    if (total_value > 1e-9 && std::isfinite(total_value) && !colors.empty()) {
+        double current_angle_deg = 0;
+        int color_index = 0;
+
+        for (const auto& item : raw_data) {
+            PieSliceInfo slice;
+            slice.label = item.first;
+            slice.value = item.second;
+            slice.percentage = (item.second / total_value) * 100.0;
+            slice.start_angle_deg = current_angle_deg;
+            slice.end_angle_deg = current_angle_deg + (slice.percentage / 100.0) * 360.0;
+            slice.color = colors[color_index % colors.size()];
+            color_index++;
+            slices_info.push_back(slice);
+            current_angle_deg = slice.end_angle_deg;
+        }
+    }
+    return slices_info;
+}
+
+// Impress12x20 metni resim snrnda krpmaz; metin sacak karakter saysna indirilir.
+static std::string FitText(const std::string& txt, int x, int image_width) {
+    int max_chars = (image_width - x) / 12; // 12px/char
+    if (max_chars <= 0) return std::string();
+    return txt.size() > static_cast<size_t>(max_chars) ? txt.substr(0, max_chars) : txt;
+}
+
+// Yerleim tuval trnden bamszdr; Canvas, Create/Text/Arc/Line/FillRect salamaldr.
+template <class Canvas>
+static void DrawPieChart(Canvas& canvas, const std::vector<PieSliceInfo>& slices,
+    const char* chart_title, int image_width, int image_height,
+    int center_x, int center_y, int radius,
+    unsigned int backcolor, unsigned int textcolor) {
+
+    // Marjlar ve dier sabitler
+    int top_margin_for_title = 30;      // Balk iin st boluk
+    int legend_label_offset_x = 25;   // Lejantta renk kutucuu ile metin aras boluk
+    int legend_color_box_size = 15;   // Lejanttaki renk kutucuunun boyutu
+    int legend_item_spacing_y = 25;   // Lejanttaki satrlar aras dikey boluk
+    int legend_initial_x_offset = 30; // Pastann sandan lejantn ne kadar uzakta balayaca
+    int legend_initial_y_offset = 20; // Baln altndan lejantn ne kadar aada balayaca
+
+
+    canvas.Create(image_width, image_height, backcolor);
+
+    // Balk
+    if (chart_title && strlen(chart_title) > 0) {
+        int title_len_px = static_cast<int>(strlen(chart_title)) * 12; // Yaklak piksel uzunluu (12px/char varsaym)
+        int title_x_pos = (image_width - title_len_px) / 2; // Resmi ortala
+        if (title_x_pos < 5) title_x_pos = 5; // Kenara ok yapmasn
+        std::string title = FitText(chart_title, title_x_pos, image_width);
+        // Impress12x20 font ykseklii ~20px. Marjn ortasna yerletirmek iin:
+        if (!title.empty()) canvas.Text(title_x_pos, (top_margin_for_title - 20) / 2, title.c_str(), textcolor);
+    }
+
+    if (slices.empty()) {
+        canvas.Text(10, top_margin_for_title + 10, "Pasta grafik icin veri yok.", textcolor);
+        return;
+    }
+
+    // Dilimleri iz
+    for (const auto& slice : slices) {
+        canvas.Arc(center_x, center_y, radius,
+            slice.color, static_cast<int>(slice.start_angle_deg), static_cast<int>(slice.end_angle_deg));
+
+        double start_rad = slice.start_angle_deg * M_PI / 180.0;
+        double end_rad = slice.end_angle_deg * M_PI / 180.0;
+
+        // Yayn balang ve biti noktalarn hesapla (Y ekseni aa doru artar)
+        // GDI+'da veya benzeri sistemlerde Y genellikle yukar doru artar, bu yzden sins negatif olur.
+        // Ancak I-See-Bytes'n Line fonksiyonunun nasl altna bal.
+        // Ekran koordinatlar (sol st 0,0, Y aa) iin sins pozitif kalmal.
+        int x_start_on_arc = center_x + static_cast<int>(radius * cos(start_rad));
+        int y_start_on_arc = center_y + static_cast<int>(radius * sin(start_rad));
+
+        int x_end_on_arc = center_x + static_cast<int>(radius * cos(end_rad));
+        int y_end_on_arc = center_y + static_cast<int>(radius * sin(end_rad));
+
+        canvas.Line(center_x, center_y, x_start_on_arc, y_start_on_arc, slice.color);
+        canvas.Line(center_x, center_y, x_end_on_arc, y_end_on_arc, slice.color);
+    }
+
+    // Lejant / Etiketler
+    int legend_x_start = center_x + radius + legend_initial_x_offset;
+    int legend_y_start = top_margin_for_title + legend_initial_y_offset;
+
+    for (size_t i = 0; i < slices.size(); ++i) {
+        const auto& slice = slices[i];
+        // Lejantn Y pozisyonu, metnin dikeyde ortalanmas iin metin yksekliinin yars (~10px) dlerek
+        int current_y_for_text = legend_y_start + i * legend_item_spacing_y;
+        int current_y_for_box = current_y_for_text; // Kutu ve metin ayn hizada balasn
+
+        if (current_y_for_box + legend_color_box_size > image_height - 5) break; // Lejant resim dna tayorsa izme
+        if (legend_x_start + legend_color_box_size > image_width) break;          // Dar resimde lejanta yer yok
+
+        canvas.FillRect(legend_x_start, current_y_for_box, legend_color_box_size, legend_color_box_size, slice.color);
+
+        // Etiket a zerinden gelebilir (CHART_MAX_TEXT bayta kadar); sabit boyutlu tampona yazlmaz
+        char percent_text[32];
+        sprintf_s(percent_text, sizeof(percent_text), " (%.1f%%)", slice.percentage);
+        int text_x = legend_x_start + legend_color_box_size + 5; // Renk kutusundan 5px saa
+        std::string legend_text = FitText(slice.label + percent_text, text_x, image_width);
+        if (!legend_text.empty()) canvas.Text(text_x, current_y_for_text, legend_text.c_str(), textcolor);
+    }
+}
+
+// ICBYTES tuvaline ktphane fonksiyonlaryla izer
+struct IcbCanvas {
+    ICBYTES& img;
+    void Create(int w, int h, unsigned int backcolor) {
+        CreateImage(img, w, h, ICB_UINT);
+        img = backcolor;
+    }
+    void Text(int x, int y, const char* txt, unsigned int color) { Impress12x20(img, x, y, txt, color); }
+    void Arc(int x, int y, int r, unsigned int color, int arc_strt, int arc_end) {
+        TiltedEllipseArc(img, x, y, r, r, 0, color, arc_strt, arc_end);
+    }
+    void Line(int x1, int y1, int x2, int y2, unsigned int color) { ::Line(img, x1, y1, x2, y2, color); }
+    void FillRect(int x, int y, int w, int h, unsigned int color) { ::FillRect(img, x, y, w, h, color); }
+};
+
+void CreatePieChart(ICBYTES& img, const std::vector<PieSliceInfo>& slices,
+    const char* chart_title, int image_width, int image_height,
+    int center_x, int center_y, int radius,
+    unsigned int backcolor, unsigned int textcolor) {
+    IcbCanvas canvas = { img };
+    DrawPieChart(canvas, slices, chart_title, image_width, image_height, center_x, center_y, radius, backcolor, textcolor);
+}
+
+void CreatePieChart(IndexedCanvas& canvas, const std::vector<PieSliceInfo>& slices,
+    const char* chart_title, int image_width, int image_height,
+    int center_x, int center_y, int radius,
+    unsigned int backcolor, unsigned int textcolor) {
+    DrawPieChart(canvas, slices, chart_title, image_width, image_height, center_x, center_y, radius, backcolor, textcolor);
+}
+
+bool EncodeBMP(ICBYTES& img, std::vector<unsigned char>& out) {
+    if (GetType(img) != ICB_UINT) return false;
+    long long w = img.X(), h = img.Y();
+    if (w <= 0 || h <= 0) return false;
+
+    long long row_bytes = w * 4;
+    long long pixel_bytes = row_bytes * h;
+
+    unsigned char* p = BeginBMP(out, static_cast<int>(w), static_cast<int>(h), 32, 0, static_cast<size_t>(pixel_bytes));
+
+    // ICBYTES indeksleri 1'den balar; her satr bellekte ardk olduundan satr satr kopyalanr.
+    for (long long y = 1; y <= h; y++) {
+        memcpy(p, &img.U(1, y), static_cast<size_t>(row_bytes));
+        p += row_bytes;
+    }
+    return true;
+}
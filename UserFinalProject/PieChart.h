@@ -0,0 +1,42 @@
+// PieChart.h
+// Pasta grafik izimi; hem GUI uygulamas hem de ChartService tarafndan kullanlr.
+#pragma once
+#include "icbytes.h"
+#include "IndexedCanvas.h"
+
+#include <vector>
+#include <string>
+#include <utility>
+
+// Yardmc yap, her dilim iin bilgi tutar
+struct PieSliceInfo {
+    std::string label;
+    double value;
+    double percentage;
+    double start_angle_deg;
+    double end_angle_deg;
+    unsigned int color;
+};
+
+// Varsaylan renk paleti (daha fazla dilim iin geniletilebilir)
+const std::vector<unsigned int>& DefaultPieColors();
+
+// Ham (etiket, deer) listesinden alar ve renkleri hesaplanm dilimleri retir.
+// Toplam sfrsa bo liste dner.
+std::vector<PieSliceInfo> BuildPieSlices(const std::vector<std::pair<std::string, double>>& raw_data,
+    const std::vector<unsigned int>& colors = DefaultPieColors());
+
+// Pasta Grafik Fonksiyonu
+void CreatePieChart(ICBYTES& img, const std::vector<PieSliceInfo>& slices,
+    const char* chart_title, int image_width, int image_height,
+    int center_x, int center_y, int radius,
+    unsigned int backcolor = 0xFFFFFFFF, unsigned int textcolor = 0xFF000000);
+
+// Ayn grafii paletli tuvale izer; tuvalin bit derinlii nceden seilir.
+void CreatePieChart(IndexedCanvas& canvas, const std::vector<PieSliceInfo>& slices,
+    const char* chart_title, int image_width, int image_height,
+    int center_x, int center_y, int radius,
+    unsigned int backcolor = 0xFFFFFFFF, unsigned int textcolor = 0xFF000000);
+
+// ICB_UINT resmi 32 bit BMP dosya baytlarna kodlar (dosya bal dahil).
+bool EncodeBMP(ICBYTES& img, std::vector<unsigned char>& out);
@@ -0,0 +1,27 @@
+// Raster.cpp
+#include "Raster.h"
+
+#include <windows.h>
+#include <cstring>
+
+unsigned char* BeginBMP(std::vector<unsigned char>& out, int width, int height, int bits, int colors, size_t pixel_bytes) {
+    BITMAPFILEHEADER fh = {};
+    BITMAPINFOHEADER ih = {};
+    fh.bfType = 0x4D42; // "BM"
+    fh.bfOffBits = static_cast<DWORD>(sizeof(fh) + sizeof(ih) + colors * 4);
+    fh.bfSize = static_cast<DWORD>(fh.bfOffBits + pixel_bytes);
+    ih.biSize = sizeof(ih);
+    ih.biWidth = width;
+    ih.biHeight = -height; // Negatif ykseklik: satrlar yukardan aaya
+    ih.biPlanes = 1;
+    ih.biBitCount = static_cast<WORD>(bits);
+    ih.biCompression = BI_RGB;
+    ih.biSizeImage = static_cast<DWORD>(pixel_bytes);
+    ih.biClrUsed = colors;
+
+    out.resize(fh.bfSize);
+    unsigned char* p = out.data();
+    memcpy(p, &fh, sizeof(fh));
+    memcpy(p + sizeof(fh), &ih, sizeof(ih));
+    return p + sizeof(fh) + sizeof(ih);
+}
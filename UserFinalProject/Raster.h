@@ -0,0 +1,27 @@
+// Raster.h
+// Farkl piksel dzenli tuvallerin (ICB_UINT resim, IndexedCanvas) ortak kulland
+// izgi izme ve BMP bal yardmclar.
+#pragma once
+#include <vector>
+#include <cstdlib>
+#include <cstddef>
+
+// Bresenham; iki u dahil. plot(x, y) her piksel iin bir kez arlr, krpma plot'a aittir.
+template<class Plot>
+inline void RasterLine(int x1, int y1, int x2, int y2, Plot&& plot) {
+    int dx = abs(x2 - x1), sx = x1 < x2 ? 1 : -1;
+    int dy = -abs(y2 - y1), sy = y1 < y2 ? 1 : -1;
+    int err = dx + dy;
+    for (;;) {
+        plot(x1, y1);
+        if (x1 == x2 && y1 == y2) break;
+        int e2 = 2 * err;
+        if (e2 >= dy) { err += dy; x1 += sx; }
+        if (e2 <= dx) { err += dx; y1 += sy; }
+    }
+}
+
+// Satrlar yukardan aaya (negatif ykseklik) sktrlmam BMP'nin dosya ve bilgi
+// baln yazar. out balk, colors girdilik palet ve pixel_bytes iin boyutlanr.
+// Dn: paletin, palet yoksa piksellerin yazlaca konum.
+unsigned char* BeginBMP(std::vector<unsigned char>& out, int width, int height, int bits, int colors, size_t pixel_bytes);
@@ -0,0 +1,83 @@
+// ServiceMain.cpp
+// ChartService.exe serve [--port N] [--unix YOL] [--workers N] [--batch N] [--queue N] [--inflight N] [--pending-mb N] [--stats MS]
+//                        [--cache-mb N] [--cache-dir KLASOR] [--cache-disk-mb N] [--canvas 4|8|32]
+// ChartService.exe load  [--port N] [--unix YOL] [--conns N] [--depth N] [--requests N] [--distinct N] [--size GxY]
+#include "ChartService.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// ICBYTES ktphanesi GUI giri noktas iin bu iki fonksiyonu bekler.
+// Servis penceresiz altndan bo braklr.
+void ICGUI_Create() {}
+void ICGUI_main() {}
+
+static void Usage() {
+    printf("Kullanim:\n");
+    printf("  ChartService serve [--port N] [--unix YOL] [--workers N] [--batch N] [--queue N] [--inflight N] [--pending-mb N] [--stats MS]\n");
+    printf("                     [--cache-mb N] [--cache-dir KLASOR] [--cache-disk-mb N] [--canvas 4|8|32]\n");
+    printf("  ChartService load  [--port N] [--unix YOL] [--conns N] [--depth N] [--requests N] [--distinct N] [--size GxY]\n");
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        Usage();
+        return 1;
+    }
+
+    bool serve = strcmp(argv[1], "serve") == 0;
+    bool load = strcmp(argv[1], "load") == 0;
+    if (!serve && !load) {
+        Usage();
+        return 1;
+    }
+
+    ChartServiceConfig scfg;
+    ChartLoadConfig lcfg;
+    for (int i = 2; i < argc; i += 2) {
+        const char* opt = argv[i];
+        if (i + 1 >= argc) {
+            printf("Secenek icin deger eksik: %s\n", opt);
+            Usage();
+            return 1;
+        }
+        const char* val = argv[i + 1];
+        if (!strcmp(opt, "--port")) scfg.port = lcfg.port = atoi(val);
+        else if (!strcmp(opt, "--unix")) scfg.unix_path = lcfg.unix_path = val;
+        else if (!strcmp(opt, "--workers")) scfg.workers = atoi(val);
+        else if (!strcmp(opt, "--batch")) scfg.batch_size = atoi(val);
+        else if (!strcmp(opt, "--queue")) scfg.queue_limit = atoi(val);
+        else if (!strcmp(opt, "--inflight")) scfg.max_inflight_per_conn = atoi(val);
+        else if (!strcmp(opt, "--pending-mb")) scfg.max_pending_mb_per_conn = atoi(val);
+        else if (!strcmp(opt, "--stats")) scfg.stats_interval_ms = atoi(val);
+        else if (!strcmp(opt, "--cache-mb")) scfg.cache_mb = atoi(val);
+        else if (!strcmp(opt, "--cache-dir")) scfg.cache_dir = val;
+        else if (!strcmp(opt, "--cache-disk-mb")) scfg.cache_disk_mb = atoi(val);
+        else if (!strcmp(opt, "--canvas")) {
+            scfg.canvas_bits = atoi(val);
+            if (scfg.canvas_bits != 4 && scfg.canvas_bits != 8 && scfg.canvas_bits != 32) {
+                printf("Gecersiz --canvas degeri: %s\n", val);
+                Usage();
+                return 1;
+            }
+        }
+        else if (!strcmp(opt, "--conns")) lcfg.connections = atoi(val);
+        else if (!strcmp(opt, "--depth")) lcfg.depth = atoi(val);
+        else if (!strcmp(opt, "--requests")) lcfg.requests = atoi(val);
+        else if (!strcmp(opt, "--distinct")) lcfg.distinct = atoi(val);
+        else if (!strcmp(opt, "--size")) {
+            if (sscanf_s(val, "%dx%d", &lcfg.width, &lcfg.height) != 2) {
+                Usage();
+                return 1;
+            }
+        }
+        else {
+            printf("Bilinmeyen secenek: %s\n", opt);
+            Usage();
+            return 1;
+        }
+    }
+
+    return serve ? RunChartService(scfg) : RunChartLoadGenerator(lcfg);
+}